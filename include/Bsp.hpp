@@ -0,0 +1,423 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <GraphPartition.hpp>
+
+namespace algo {
+namespace bsp {
+
+// Full mesh of Unix stream sockets between k local processes standing in for nodes.
+// Created before fork, every process then keeps only its own ends with attach().
+class Channel
+{
+public:
+  explicit Channel(int k): _k(k), _me(-1), _fds(k, std::vector<int>(k, -1))
+  {
+    for(int i=0; i<k; ++i) {
+      for(int j=i+1; j<k; ++j) {
+        int pair[2];
+        if(socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+          close();
+          throw std::runtime_error(std::string("socketpair: ") + std::strerror(errno));
+        }
+        _fds[i][j] = pair[0];
+        _fds[j][i] = pair[1];
+      }
+    }
+  }
+
+  Channel(const Channel&) = delete;
+  Channel& operator=(const Channel&) = delete;
+
+  ~Channel()
+  {
+    close();
+  }
+
+  // Keeps the ends of process me, sockets are switched to non-blocking
+  void attach(int me)
+  {
+    _me = me;
+    for(int i=0; i<_k; ++i) {
+      for(int j=0; j<_k; ++j) {
+        if(_fds[i][j] >= 0 && i != me) {
+          ::close(_fds[i][j]);
+          _fds[i][j] = -1;
+        }
+      }
+    }
+    for(int p=0; p<_k; ++p) {
+      if(p != me) {
+        fcntl(_fds[me][p], F_SETFL, fcntl(_fds[me][p], F_GETFL) | O_NONBLOCK);
+      }
+    }
+  }
+
+  // Drops all ends, for the process that only forks the peers
+  void detach()
+  {
+    close();
+  }
+
+  // Sends out[p] to every peer p and returns what each peer sent, in[me] = out[me].
+  // All processes have to call it the same number of times. Sends and receives are
+  // interleaved through poll, so large messages cannot deadlock on socket buffers.
+  template<typename T>
+  std::vector<std::vector<T>> exchange(const std::vector<std::vector<T>>& out)
+  {
+    struct Transfer
+    {
+      uint64_t header = 0;
+      size_t done = 0;
+    };
+    std::vector<std::vector<T>> in(_k);
+    in[_me] = out[_me];
+    std::vector<Transfer> sending(_k), receiving(_k);
+    std::vector<uint64_t> outHeader(_k);
+    for(int p=0; p<_k; ++p) {
+      outHeader[p] = out[p].size();
+    }
+
+    auto sendSize = [&](int p) { return sizeof(uint64_t) + out[p].size()*sizeof(T); };
+    auto recvSize = [&](int p) { return sizeof(uint64_t) + receiving[p].header*sizeof(T); };
+    auto pending = [&](int p, bool send) {
+      return p != _me && (send ? sending[p].done < sendSize(p) : receiving[p].done < recvSize(p));
+    };
+
+    std::vector<pollfd> polls;
+    while(true) {
+      polls.clear();
+      for(int p=0; p<_k; ++p) {
+        const short events = (pending(p, true) ? POLLOUT : 0) | (pending(p, false) ? POLLIN : 0);
+        if(events) {
+          polls.push_back({_fds[_me][p], events, 0});
+        }
+      }
+      if(polls.empty()) {
+        return in;
+      }
+      if(poll(polls.data(), polls.size(), -1) < 0) {
+        if(errno == EINTR) {
+          continue;
+        }
+        throw std::runtime_error(std::string("poll: ") + std::strerror(errno));
+      }
+      for(const auto& pfd: polls) {
+        const int p = peer(pfd.fd);
+        if((pfd.revents & POLLOUT) && pending(p, true)) {
+          auto& s = sending[p];
+          const char* header = reinterpret_cast<const char*>(&outHeader[p]);
+          const char* data = reinterpret_cast<const char*>(out[p].data());
+          const ssize_t n = s.done < sizeof(uint64_t)
+            ? send(pfd.fd, header + s.done, sizeof(uint64_t) - s.done, MSG_NOSIGNAL)
+            : send(pfd.fd, data + s.done - sizeof(uint64_t), sendSize(p) - s.done, MSG_NOSIGNAL);
+          if(n < 0 && errno != EAGAIN && errno != EINTR) {
+            throw std::runtime_error("Peer " + std::to_string(p) + " lost: " + std::strerror(errno));
+          }
+          s.done += std::max<ssize_t>(n, 0);
+        }
+        if((pfd.revents & (POLLIN | POLLHUP | POLLERR)) && pending(p, false)) {
+          auto& r = receiving[p];
+          char* header = reinterpret_cast<char*>(&r.header);
+          const ssize_t n = r.done < sizeof(uint64_t)
+            ? recv(pfd.fd, header + r.done, sizeof(uint64_t) - r.done, 0)
+            : recv(pfd.fd, reinterpret_cast<char*>(in[p].data()) + r.done - sizeof(uint64_t), recvSize(p) - r.done, 0);
+          if(n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR)) {
+            throw std::runtime_error("Peer " + std::to_string(p) + " lost");
+          }
+          r.done += std::max<ssize_t>(n, 0);
+          if(r.done == sizeof(uint64_t)) {
+            in[p].resize(r.header);
+          }
+        }
+      }
+    }
+  }
+
+  // Sum of value over all processes
+  uint64_t allReduce(uint64_t value)
+  {
+    auto in = exchange(std::vector<std::vector<uint64_t>>(_k, {value}));
+    uint64_t sum = 0;
+    for(const auto& v: in) {
+      sum += v[0];
+    }
+    return sum;
+  }
+
+private:
+  int peer(int fd) const
+  {
+    for(int p=0; p<_k; ++p) {
+      if(_fds[_me][p] == fd) {
+        return p;
+      }
+    }
+    return -1;
+  }
+
+  void close()
+  {
+    for(auto& row: _fds) {
+      for(int& fd: row) {
+        if(fd >= 0) {
+          ::close(fd);
+          fd = -1;
+        }
+      }
+    }
+  }
+
+  const int _k;
+  int _me;
+  std::vector<std::vector<int>> _fds;
+};
+
+constexpr int UNREACHED = std::numeric_limits<int>::max();
+
+struct Result
+{
+  std::vector<int> values;   // UNREACHED for vertices not reached
+  size_t supersteps = 0;
+  size_t messages = 0;       // Updates sent between processes
+  bool negativeCycle = false;
+};
+
+namespace detail {
+
+struct Update
+{
+  int vertex;
+  int value;
+};
+
+inline void writeAll(int fd, const void* data, size_t size)
+{
+  const char* p = static_cast<const char*>(data);
+  while(size) {
+    const ssize_t n = send(fd, p, size, MSG_NOSIGNAL);
+    if(n < 0 && errno == EINTR) {
+      continue;
+    }
+    if(n <= 0) {
+      throw std::runtime_error("Lost coordinator");
+    }
+    p += n;
+    size -= n;
+  }
+}
+
+inline void readAll(int fd, void* data, size_t size)
+{
+  char* p = static_cast<char*>(data);
+  while(size) {
+    const ssize_t n = recv(fd, p, size, 0);
+    if(n < 0 && errno == EINTR) {
+      continue;
+    }
+    if(n <= 0) {
+      throw std::runtime_error("Lost worker");
+    }
+    p += n;
+    size -= n;
+  }
+}
+
+// Superstep loop of worker me, label correcting: updated vertices send their value to
+// the holders of their out-edges, holders relax local edges and send the best candidate
+// per target to its owner, owners keep improvements as the next frontier. With a 1D
+// partitioning the owner is the only holder and the first exchange stays local.
+template<typename EDGE, typename Relax>
+Result work(const partition::Partitioning<EDGE>& p, Channel& channel, int me, int source, Relax relax)
+{
+  const int k = p.count();
+  const int first = p.owners.begin(me);
+  std::vector<int> values(p.owners.end(me) - first, UNREACHED);
+  std::vector<bool> queued(values.size(), false);
+  std::vector<int> frontier;
+  if(p.owner(source) == me) {
+    values[source - first] = 0;
+    frontier.push_back(source);
+  }
+
+  Result result;
+  std::unordered_map<int, int> best;
+  while(true) {
+    std::vector<std::vector<Update>> expand(k);
+    for(int u: frontier) {
+      for(int h=p.firstHolder(u); h<p.lastHolder(u); ++h) {
+        expand[h].push_back({u, values[u - first]});
+      }
+    }
+    auto updates = p.cols == 1 ? std::move(expand) : channel.exchange(expand);
+
+    best.clear();
+    for(const auto& from: updates) {
+      for(const auto& [u, value]: from) {
+        for(const auto& e: p.parts[me].out(u)) {
+          const int candidate = relax(value, e);
+          auto it = best.try_emplace(e.to, candidate).first;
+          it->second = std::min(it->second, candidate);
+        }
+      }
+    }
+    std::vector<std::vector<Update>> fold(k);
+    for(const auto& [v, value]: best) {
+      fold[p.owner(v)].push_back({v, value});
+    }
+    for(int q=0; q<k; ++q) {
+      if(q != me) {
+        result.messages += fold[q].size() + (p.cols == 1 ? 0 : expand[q].size());
+      }
+    }
+
+    frontier.clear();
+    for(const auto& from: channel.exchange(fold)) {
+      for(const auto& [v, value]: from) {
+        if(value < values[v - first]) {
+          values[v - first] = value;
+          if(!queued[v - first]) {
+            queued[v - first] = true;
+            frontier.push_back(v);
+          }
+        }
+      }
+    }
+    for(int v: frontier) {
+      queued[v - first] = false;
+    }
+
+    ++result.supersteps;
+    if(channel.allReduce(frontier.size()) == 0) {
+      break;
+    }
+    if(result.supersteps >= p.vertices) {
+      // Shortest paths have at most n - 1 edges
+      result.negativeCycle = true;
+      break;
+    }
+  }
+  result.values = std::move(values);
+  return result;
+}
+
+} // namespace detail
+
+// Forks one worker process per part, runs the superstep loop with relax(value, edge)
+// giving the candidate label of edge.to, and gathers the labels. Workers inherit the
+// whole partitioning but touch only their part and talk only through the channel.
+template<typename EDGE, typename Relax>
+Result run(const partition::Partitioning<EDGE>& p, int source, Relax relax)
+{
+  const int k = p.count();
+  Channel channel(k);
+  std::vector<std::pair<int, int>> links(k);
+  for(auto& [parent, child]: links) {
+    int pair[2];
+    if(socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+      throw std::runtime_error(std::string("socketpair: ") + std::strerror(errno));
+    }
+    parent = pair[0];
+    child = pair[1];
+  }
+
+  std::vector<pid_t> workers;
+  for(int me=0; me<k; ++me) {
+    const pid_t pid = fork();
+    if(pid < 0) {
+      for(pid_t w: workers) {
+        kill(w, SIGKILL);
+        waitpid(w, nullptr, 0);
+      }
+      throw std::runtime_error(std::string("fork: ") + std::strerror(errno));
+    }
+    if(pid == 0) {
+      int status = 0;
+      try {
+        for(int other=0; other<k; ++other) {
+          close(links[other].first);
+          if(other != me) {
+            close(links[other].second);
+          }
+        }
+        channel.attach(me);
+        const Result r = detail::work(p, channel, me, source, relax);
+        const uint64_t header[] = {r.supersteps, r.messages, r.negativeCycle, r.values.size()};
+        detail::writeAll(links[me].second, header, sizeof(header));
+        detail::writeAll(links[me].second, r.values.data(), r.values.size()*sizeof(int));
+      } catch(...) {
+        status = 1;
+      }
+      _exit(status);
+    }
+    workers.push_back(pid);
+  }
+  // Peers must see a lost worker as a closed socket
+  channel.detach();
+  for(auto& [parent, child]: links) {
+    close(child);
+  }
+
+  Result result;
+  result.values.assign(p.vertices, UNREACHED);
+  bool failed = false;
+  for(int me=0; me<k && !failed; ++me) {
+    try {
+      uint64_t header[4];
+      detail::readAll(links[me].first, header, sizeof(header));
+      detail::readAll(links[me].first, result.values.data() + p.owners.begin(me), header[3]*sizeof(int));
+      result.supersteps = header[0];
+      result.messages += header[1];
+      result.negativeCycle = result.negativeCycle || header[2];
+    } catch(const std::exception&) {
+      failed = true;
+    }
+  }
+  for(pid_t w: workers) {
+    if(failed) {
+      kill(w, SIGKILL);
+    }
+    int status = 0;
+    waitpid(w, &status, 0);
+    failed = failed || !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+  }
+  for(auto& [parent, child]: links) {
+    close(parent);
+  }
+  if(failed) {
+    throw std::runtime_error("BSP worker failed");
+  }
+  return result;
+}
+
+// Hop distances from source
+template<typename EDGE>
+Result bfs(const partition::Partitioning<EDGE>& p, int source)
+{
+  return run(p, source, [](int depth, const EDGE&) { return depth + 1; });
+}
+
+// Shortest distances from source, negativeCycle is set when one is reachable
+template<typename EDGE>
+Result bellmanFord(const partition::Partitioning<EDGE>& p, int source)
+{
+  return run(p, source, [](int distance, const EDGE& e) { return distance + e.weight; });
+}
+
+} // namespace bsp
+} // namespace algo
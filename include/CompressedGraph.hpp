@@ -0,0 +1,204 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <CsrGraph.hpp>
+#include <Graph.hpp>
+#include <Parallel.hpp>
+
+namespace algo {
+
+namespace varint {
+
+inline void put(std::vector<uint8_t>& out, uint64_t value)
+{
+  while(value >= 0x80) {
+    out.push_back(static_cast<uint8_t>(value) | 0x80);
+    value >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+inline uint64_t get(const uint8_t*& p)
+{
+  uint64_t value = *p & 0x7F;
+  int shift = 7;
+  while(*p++ & 0x80) {
+    value |= static_cast<uint64_t>(*p & 0x7F) << shift;
+    shift += 7;
+  }
+  return value;
+}
+
+// Maps signed to unsigned so small negative deltas stay short
+inline uint64_t zigzag(int64_t v)
+{
+  return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t unzigzag(uint64_t v)
+{
+  return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+} // namespace varint
+
+// Read-only directed graph with gap encoded adjacency. Block of vertex u holds its degree,
+// then its sorted neighbours: first as zigzag delta from u, the rest as gaps to the
+// previous neighbour, all LEB128 varints. Well ordered graphs (see GraphReorder.hpp)
+// need one or two bytes per edge instead of four. Block offsets are two level, a 64 bit
+// base per 256 vertices plus a 32 bit offset per vertex relative to it.
+// Neighbours are decoded on the fly as GenericEdge, so generic traversals work unchanged.
+class CompressedGraph
+{
+public:
+  using EdgeType=GenericEdge;
+  static constexpr bool Directed=true;
+
+  class Iterator
+  {
+  public:
+    Iterator(const uint8_t* p, size_t left, int u): _p(p), _left(left), _value(u)
+    {
+      if(_left) {
+        _value += varint::unzigzag(varint::get(_p));
+      }
+    }
+
+    GenericEdge operator*() const
+    {
+      return {_value};
+    }
+
+    Iterator& operator++()
+    {
+      if(--_left) {
+        _value += varint::get(_p);
+      }
+      return *this;
+    }
+
+    bool operator!=(const Iterator& rhs) const
+    {
+      return _left != rhs._left;
+    }
+
+    bool operator==(const Iterator& rhs) const
+    {
+      return _left == rhs._left;
+    }
+
+  private:
+    const uint8_t* _p;
+    size_t _left;
+    int _value;
+  };
+
+  struct NeighbourRange
+  {
+    const uint8_t* data;
+    size_t degree;
+    int u;
+
+    Iterator begin() const { return Iterator(data, degree, u); }
+    Iterator end() const { return Iterator(nullptr, 0, u); }
+    size_t size() const { return degree; }
+    bool empty() const { return degree == 0; }
+  };
+
+  // Encodes any graph providing vertices() and edges(u). Offset blocks are spread over
+  // threads, each encodes into its own buffer, buffers are then concatenated.
+  // Adjacency of 256 consecutive vertices has to fit in 4 GiB.
+  template<typename G>
+  CompressedGraph(const G& g, unsigned threads = hardwareThreads()):
+    _size(g.vertices()), _base(((_size + BLOCK - 1) >> BLOCK_BITS) + 1, 0), _relative(_size)
+  {
+    const size_t blocks = _base.size() - 1;
+    threads = std::max(1u, std::min<unsigned>(threads, std::max<size_t>(blocks, 1)));
+    std::vector<std::vector<uint8_t>> parts(threads);
+    parallelFor(threads, blocks, [&](size_t first, size_t last, unsigned id) {
+      auto& out = parts[id];
+      std::vector<int> neighbours;
+      for(size_t block=first; block<last; ++block) {
+        _base[block] = out.size();
+        for(size_t u=block << BLOCK_BITS; u<std::min(_size, (block+1) << BLOCK_BITS); ++u) {
+          _relative[u] = out.size() - _base[block];
+          neighbours.clear();
+          for(const auto& e: g.edges(u)) {
+            neighbours.push_back(e.to);
+          }
+          std::sort(neighbours.begin(), neighbours.end());
+          varint::put(out, neighbours.size());
+          int64_t previous = u;
+          for(size_t i=0; i<neighbours.size(); ++i) {
+            varint::put(out, i ? neighbours[i] - previous : varint::zigzag(neighbours[i] - previous));
+            previous = neighbours[i];
+          }
+        }
+      }
+    });
+
+    std::vector<size_t> start(threads+1, 0);
+    for(unsigned t=0; t<threads; ++t) {
+      start[t+1] = start[t] + parts[t].size();
+    }
+    _data.resize(start[threads]);
+    parallelFor(threads, blocks, [&](size_t first, size_t last, unsigned id) {
+      for(size_t block=first; block<last; ++block) {
+        _base[block] += start[id];
+      }
+      if(!parts[id].empty()) {
+        std::memcpy(_data.data() + start[id], parts[id].data(), parts[id].size());
+      }
+      std::vector<uint8_t>().swap(parts[id]);
+    });
+    _base[blocks] = _data.size();
+  }
+
+  size_t vertices() const
+  {
+    return _size;
+  }
+
+  NeighbourRange edges(int u) const
+  {
+    const uint8_t* p = _data.data() + _base[u >> BLOCK_BITS] + _relative[u];
+    const size_t degree = varint::get(p);
+    return {p, degree, u};
+  }
+
+  size_t edgeCount() const
+  {
+    size_t m = 0;
+    for(size_t u=0; u<vertices(); ++u) {
+      m += edges(u).size();
+    }
+    return m;
+  }
+
+  // Compressed graph with every edge reversed
+  CompressedGraph transposed(unsigned threads = hardwareThreads()) const
+  {
+    return CompressedGraph(transposeCsr(*this, threads), threads);
+  }
+
+  // Bytes held by the representation
+  size_t memory() const
+  {
+    return _data.capacity() + _base.capacity()*sizeof(uint64_t) + _relative.capacity()*sizeof(uint32_t);
+  }
+
+private:
+  static constexpr int BLOCK_BITS = 8;
+  static constexpr size_t BLOCK = size_t(1) << BLOCK_BITS;
+
+  size_t _size;
+  std::vector<uint64_t> _base;
+  std::vector<uint32_t> _relative;
+  std::vector<uint8_t> _data;
+};
+
+} // namespace algo
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <iterator>
+#include <vector>
+
+#include <Graph.hpp>
+#include <Parallel.hpp>
+
+namespace algo {
+
+// Contiguous run of edges of one vertex
+template<typename EDGE>
+struct EdgeRange
+{
+  const EDGE* first;
+  const EDGE* last;
+
+  const EDGE* begin() const { return first; }
+  const EDGE* end() const { return last; }
+  const EDGE* data() const { return first; }
+  size_t size() const { return last - first; }
+  bool empty() const { return first == last; }
+  const EDGE& operator[](size_t i) const { return first[i]; }
+};
+
+// Immutable compressed sparse row graph, edges of u are edges[offsets[u] .. offsets[u+1])
+template<typename EDGE=GenericEdge>
+class CsrGraph
+{
+public:
+  using EdgeType=EDGE;
+  static constexpr bool Directed=true;
+
+  CsrGraph(std::vector<size_t>&& offsets, std::vector<EDGE>&& edges):
+    _offsets(std::move(offsets)), _edges(std::move(edges))
+  {}
+
+  size_t vertices() const
+  {
+    return _offsets.size() - 1;
+  }
+
+  size_t edgeCount() const
+  {
+    return _edges.size();
+  }
+
+  EdgeRange<EDGE> edges(int u) const
+  {
+    return {_edges.data() + _offsets[u], _edges.data() + _offsets[u+1]};
+  }
+
+  const std::vector<size_t>& offsets() const
+  {
+    return _offsets;
+  }
+
+  const std::vector<EDGE>& edgeArray() const
+  {
+    return _edges;
+  }
+
+private:
+  std::vector<size_t> _offsets;
+  std::vector<EDGE> _edges;
+};
+
+// Parallel copy of any graph providing vertices() and edges(u): degrees are counted per
+// thread block, prefix summed, then every block copies its edges into place.
+template<typename G>
+CsrGraph<typename G::EdgeType> toCsr(const G& g, unsigned threads = hardwareThreads())
+{
+  const size_t n = g.vertices();
+  std::vector<size_t> offsets(n+1, 0);
+  parallelFor(threads, n, [&](size_t begin, size_t end, unsigned) {
+    for(size_t u=begin; u<end; ++u) {
+      const auto range = g.edges(u);
+      offsets[u+1] = std::distance(range.begin(), range.end());
+    }
+  });
+  for(size_t u=0; u<n; ++u) {
+    offsets[u+1] += offsets[u];
+  }
+  std::vector<typename G::EdgeType> edges(offsets[n]);
+  parallelFor(threads, n, [&](size_t begin, size_t end, unsigned) {
+    for(size_t u=begin; u<end; ++u) {
+      std::copy(g.edges(u).begin(), g.edges(u).end(), edges.begin() + offsets[u]);
+    }
+  });
+  return CsrGraph<typename G::EdgeType>(std::move(offsets), std::move(edges));
+}
+
+// Graph with every edge reversed, all other edge fields are kept. Edges into v are
+// ordered by source whatever the thread count. The input is only read.
+template<typename G>
+CsrGraph<typename G::EdgeType> transposeCsr(const G& g, unsigned threads = hardwareThreads())
+{
+  using Edge = typename G::EdgeType;
+  const size_t n = g.vertices();
+  std::vector<Edge> edges;
+  auto offsets = countingSort(n, n, [&g](size_t begin, size_t end, auto&& emit) {
+    for(size_t u=begin; u<end; ++u) {
+      for(const auto& e: g.edges(u)) {
+        Edge r = e;
+        r.to = u;
+        emit(e.to, r);
+      }
+    }
+  }, edges, threads);
+  return CsrGraph<Edge>(std::move(offsets), std::move(edges));
+}
+
+} // namespace algo
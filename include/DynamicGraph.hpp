@@ -0,0 +1,413 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <CsrGraph.hpp>
+#include <Graph.hpp>
+#include <Parallel.hpp>
+
+namespace algo {
+
+// Graph updated by batches while readers query it. Every applied batch publishes a new
+// immutable Snapshot: a CSR base shared between versions plus a delta log of inserted and
+// deleted edges per touched vertex. Deltas live in a persistent radix tree, a batch copies
+// the deltas of the vertices it touches and the tree nodes above them, everything else
+// stays shared with older versions. Grabbing the current snapshot goes through the shared_ptr atomic
+// functions, which may take a short internal lock, traversing it never locks and writers
+// never modify published data. When the delta log outgrows a fraction of the base it is
+// compacted into a fresh CSR base off the reader path.
+template<typename EDGE=GenericEdge>
+class DynamicGraph
+{
+public:
+  using EdgeType=EDGE;
+
+  struct VertexDelta
+  {
+    std::vector<EDGE> inserted;
+    std::vector<int> deleted;  // sorted targets removed from the base
+
+    size_t size() const
+    {
+      return inserted.size() + deleted.size();
+    }
+  };
+
+  // Persistent map from vertex id to delta, 32 ids per leaf and 32 children per inner node.
+  // Updates copy the paths to the updated ids and return a new tree.
+  class DeltaTree
+  {
+  public:
+    using Entry = std::pair<int, std::shared_ptr<const VertexDelta>>;
+
+    const VertexDelta* find(int u) const
+    {
+      if(!_root || static_cast<size_t>(u) >= capacity(_height)) {
+        return nullptr;
+      }
+      const Node* node = _root.get();
+      for(int level=_height; level>0 && node; --level) {
+        node = node->children[slot(u, level)].get();
+      }
+      return node ? node->deltas[slot(u, 0)].get() : nullptr;
+    }
+
+    // Tree with the deltas of entries, sorted by id, replaced
+    DeltaTree with(const std::vector<Entry>& entries) const
+    {
+      if(entries.empty()) {
+        return *this;
+      }
+      DeltaTree result = *this;
+      while(static_cast<size_t>(entries.back().first) >= capacity(result._height)) {
+        if(result._root) {
+          auto root = std::make_shared<Node>(result._height + 1);
+          root->children[0] = std::move(result._root);
+          result._root = std::move(root);
+        }
+        ++result._height;
+      }
+      result._root = assign(result._root, result._height, entries.begin(), entries.end());
+      return result;
+    }
+
+  private:
+    static constexpr int BITS = 5;
+    static constexpr size_t FANOUT = size_t(1) << BITS;
+
+    struct Node
+    {
+      explicit Node(int level)
+      {
+        if(level == 0) {
+          deltas.resize(FANOUT);
+        } else {
+          children.resize(FANOUT);
+        }
+      }
+
+      std::vector<std::shared_ptr<const Node>> children;
+      std::vector<std::shared_ptr<const VertexDelta>> deltas;
+    };
+
+    using EntryIterator = typename std::vector<Entry>::const_iterator;
+
+    static size_t capacity(int height)
+    {
+      return size_t(1) << std::min<size_t>(BITS*(height+1), 8*sizeof(int));
+    }
+
+    static size_t slot(int u, int level)
+    {
+      return (static_cast<size_t>(u) >> (BITS*level)) & (FANOUT-1);
+    }
+
+    // Copy of node with the entries below it replaced, each touched node is copied once
+    static std::shared_ptr<const Node> assign(const std::shared_ptr<const Node>& node, int level, EntryIterator first, EntryIterator last)
+    {
+      auto copy = node ? std::make_shared<Node>(*node) : std::make_shared<Node>(level);
+      while(first != last) {
+        const size_t i = slot(first->first, level);
+        auto end = std::find_if(first, last, [&](const Entry& e) { return slot(e.first, level) != i; });
+        if(level == 0) {
+          copy->deltas[i] = std::prev(end)->second;
+        } else {
+          copy->children[i] = assign(copy->children[i], level-1, first, end);
+        }
+        first = end;
+      }
+      return copy;
+    }
+
+    std::shared_ptr<const Node> _root;
+    int _height = 0;
+  };
+
+  class Snapshot
+  {
+  public:
+    using EdgeType=EDGE;
+    static constexpr bool Directed=true;
+
+    // Base edges not deleted, followed by inserted edges
+    class Iterator
+    {
+    public:
+      Iterator(const EDGE* base, const EDGE* baseEnd, const VertexDelta* delta):
+        _p(base), _baseEnd(baseEnd), _delta(delta), _inBase(delta != nullptr)
+      {
+        skip();
+      }
+
+      const EDGE& operator*() const
+      {
+        return *_p;
+      }
+
+      const EDGE* operator->() const
+      {
+        return _p;
+      }
+
+      Iterator& operator++()
+      {
+        ++_p;
+        skip();
+        return *this;
+      }
+
+      // Phase is compared too, base and inserted arrays may happen to be adjacent in memory
+      bool operator!=(const Iterator& rhs) const
+      {
+        return _p != rhs._p || _inBase != rhs._inBase;
+      }
+
+      bool operator==(const Iterator& rhs) const
+      {
+        return !(*this != rhs);
+      }
+
+    private:
+      void skip()
+      {
+        if(!_inBase) {
+          return;
+        }
+        while(_p != _baseEnd && std::binary_search(_delta->deleted.begin(), _delta->deleted.end(), _p->to)) {
+          ++_p;
+        }
+        if(_p == _baseEnd) {
+          _inBase = false;
+          _p = _delta->inserted.data();
+          _baseEnd = _p + _delta->inserted.size();
+        }
+      }
+
+      const EDGE* _p;
+      const EDGE* _baseEnd;
+      const VertexDelta* _delta;
+      bool _inBase;
+    };
+
+    struct Range
+    {
+      Iterator first;
+      Iterator last;
+
+      Iterator begin() const { return first; }
+      Iterator end() const { return last; }
+    };
+
+    Snapshot(std::shared_ptr<const CsrGraph<EDGE>> base, DeltaTree delta, size_t logged,
+             size_t vertices, size_t edges, size_t version):
+      _base(std::move(base)), _delta(std::move(delta)), _logged(logged), _vertices(vertices), _edges(edges), _version(version)
+    {}
+
+    size_t vertices() const
+    {
+      return _vertices;
+    }
+
+    size_t edgeCount() const
+    {
+      return _edges;
+    }
+
+    size_t version() const
+    {
+      return _version;
+    }
+
+    Range edges(int u) const
+    {
+      const EDGE* first = nullptr;
+      const EDGE* last = nullptr;
+      if(static_cast<size_t>(u) < _base->vertices()) {
+        first = _base->edges(u).begin();
+        last = _base->edges(u).end();
+      }
+      const VertexDelta* delta = _delta.find(u);
+      if(!delta) {
+        return {Iterator(first, last, nullptr), Iterator(last, last, nullptr)};
+      }
+      const EDGE* end = delta->inserted.data() + delta->inserted.size();
+      return {Iterator(first, last, delta), Iterator(end, end, nullptr)};
+    }
+
+  private:
+    friend class DynamicGraph;
+
+    std::shared_ptr<const CsrGraph<EDGE>> _base;
+    DeltaTree _delta;
+    size_t _logged;  // total size of the deltas
+    size_t _vertices;
+    size_t _edges;
+    size_t _version;
+  };
+
+  // Updates applied in order, remove(u, v) drops every u -> v edge present at that point
+  class Batch
+  {
+  public:
+    template<typename... Args>
+    void insert(int u, int v, Args&&... args)
+    {
+      _ops.push_back({u, EDGE{v, std::forward<Args>(args)...}, false});
+    }
+
+    void remove(int u, int v)
+    {
+      _ops.push_back({u, EDGE{v}, true});
+    }
+
+    bool empty() const
+    {
+      return _ops.empty();
+    }
+
+  private:
+    friend class DynamicGraph;
+
+    struct Op
+    {
+      int from;
+      EDGE edge;
+      bool remove;
+    };
+    std::vector<Op> _ops;
+  };
+
+  using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+  DynamicGraph(size_t vertices, unsigned threads = hardwareThreads()): _threads(threads)
+  {
+    std::vector<size_t> offsets(vertices+1, 0);
+    auto base = std::make_shared<const CsrGraph<EDGE>>(std::move(offsets), std::vector<EDGE>());
+    publish(std::make_shared<const Snapshot>(base, DeltaTree(), 0, vertices, 0, 0));
+  }
+
+  // Current version, readers keep it alive as long as they use it
+  SnapshotPtr snapshot() const
+  {
+    return std::atomic_load_explicit(&_current, std::memory_order_acquire);
+  }
+
+  // Builds and publishes the next version, concurrent writers are serialised. Inserts may
+  // add vertices, throws std::out_of_range for negative ids and removals of unknown vertices
+  // and then publishes nothing.
+  SnapshotPtr apply(const Batch& batch)
+  {
+    std::lock_guard<std::mutex> lock(_writer);
+    SnapshotPtr current = snapshot();
+    size_t logged = current->_logged;
+    size_t vertices = current->_vertices;
+    size_t edges = current->_edges;
+    const CsrGraph<EDGE>& base = *current->_base;
+
+    // Copy on first write, deltas of untouched vertices stay shared with current
+    std::unordered_map<int, std::shared_ptr<VertexDelta>> touched;
+    auto writable = [&](int u) -> VertexDelta& {
+      auto& copy = touched[u];
+      if(!copy) {
+        const VertexDelta* old = current->_delta.find(u);
+        copy = old ? std::make_shared<VertexDelta>(*old) : std::make_shared<VertexDelta>();
+        logged -= copy->size();
+      }
+      return *copy;
+    };
+
+    for(const auto& op: batch._ops) {
+      if(op.from < 0 || op.edge.to < 0) {
+        throw std::out_of_range("Negative vertex id");
+      }
+      if(!op.remove) {
+        vertices = std::max<size_t>(vertices, std::max(op.from, op.edge.to) + 1);
+      } else if(static_cast<size_t>(std::max(op.from, op.edge.to)) >= vertices) {
+        throw std::out_of_range("Removing an edge of an unknown vertex");
+      }
+      VertexDelta& d = writable(op.from);
+      if(!op.remove) {
+        d.inserted.push_back(op.edge);
+        ++edges;
+        continue;
+      }
+      const int v = op.edge.to;
+      auto last = std::remove_if(d.inserted.begin(), d.inserted.end(), [v](const EDGE& e) { return e.to == v; });
+      edges -= d.inserted.end() - last;
+      d.inserted.erase(last, d.inserted.end());
+      auto pos = std::lower_bound(d.deleted.begin(), d.deleted.end(), v);
+      if(static_cast<size_t>(op.from) < base.vertices() && (pos == d.deleted.end() || *pos != v)) {
+        const auto range = base.edges(op.from);
+        const size_t count = std::count_if(range.begin(), range.end(), [v](const EDGE& e) { return e.to == v; });
+        if(count) {
+          edges -= count;
+          d.deleted.insert(pos, v);
+        }
+      }
+    }
+
+    std::vector<typename DeltaTree::Entry> entries;
+    entries.reserve(touched.size());
+    for(auto& [u, d]: touched) {
+      logged += d->size();
+      entries.emplace_back(u, std::move(d));
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    DeltaTree delta = current->_delta.with(entries);
+
+    SnapshotPtr next;
+    if(logged > base.edgeCount()/8 + 1024) {
+      next = std::make_shared<const Snapshot>(compact(base, std::move(delta), vertices), DeltaTree(), 0, vertices, edges, current->_version + 1);
+    } else {
+      next = std::make_shared<const Snapshot>(current->_base, std::move(delta), logged, vertices, edges, current->_version + 1);
+    }
+    publish(next);
+    return next;
+  }
+
+private:
+  void publish(SnapshotPtr s)
+  {
+    std::atomic_store_explicit(&_current, std::move(s), std::memory_order_release);
+  }
+
+  // Merges delta log into a new CSR: parallel degree count, prefix sum, parallel scatter
+  std::shared_ptr<const CsrGraph<EDGE>> compact(const CsrGraph<EDGE>& base, DeltaTree delta, size_t n)
+  {
+    Snapshot view(std::shared_ptr<const CsrGraph<EDGE>>(&base, [](const CsrGraph<EDGE>*) {}),
+                  std::move(delta), 0, n, 0, 0);
+    std::vector<size_t> offsets(n+1, 0);
+    parallelFor(_threads, n, [&](size_t begin, size_t end, unsigned) {
+      for(size_t u=begin; u<end; ++u) {
+        for(auto it=view.edges(u).begin(), last=view.edges(u).end(); it!=last; ++it) {
+          ++offsets[u+1];
+        }
+      }
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<EDGE> edges(offsets[n]);
+    parallelFor(_threads, n, [&](size_t begin, size_t end, unsigned) {
+      for(size_t u=begin; u<end; ++u) {
+        size_t i = offsets[u];
+        for(const auto& e: view.edges(u)) {
+          edges[i++] = e;
+        }
+      }
+    });
+    return std::make_shared<const CsrGraph<EDGE>>(std::move(offsets), std::move(edges));
+  }
+
+  const unsigned _threads;
+  std::mutex _writer;
+  SnapshotPtr _current;
+};
+
+} // namespace algo
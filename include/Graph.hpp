@@ -1,7 +1,11 @@
+#pragma once
+
 #include <algorithm>
 #include <queue>
 #include <vector>
 
+#include <Parallel.hpp>
+
 namespace algo {
 
 struct GenericEdge
@@ -15,17 +19,84 @@ struct WeightedEdge
   int weight;
 };
 
+// Traversals over any graph providing edges(u) and Directed, State follows the interface
+// of GenericGraph::TraversalState. Other representations (CSR, compressed) reuse them.
+template<typename G, typename State>
+void depthFirst(const G& g, int u, State& s)
+{
+  s.discovered[u] = true;
+  s.processEarly(u);
+
+  for(const auto& e: g.edges(u)) {
+    const int v = e.to;
+    if(!s.discovered[v] && s.validEdge(e)) {
+      s.parent[v] = u;
+      s.processEdge(u,e);
+      depthFirst(g, v, s);
+    } else if (!s.processed[v] || G::Directed) {
+      s.processEdge(u,e);
+    }
+  }
+  s.processLate(u);
+  s.processed[u] = true;
+}
+
+template<typename G, typename State>
+void breadthFirst(const G& g, int start, State& s)
+{
+  std::queue<int> queue;
+  queue.push(start);
+
+  s.discovered[start] = true;
+
+  while(!queue.empty()) {
+    const int u = queue.front();
+    queue.pop();
+    s.processEarly(u);
+    s.processed[u] = true;
+    for(const auto& e: g.edges(u)) {
+      const int v = e.to;
+      if(!s.processed[v] || G::Directed) {
+        s.processEdge(u,e);
+      }
+      if(!s.discovered[v] && s.validEdge(e)) {
+        queue.push(v);
+        s.discovered[v] = true;
+        s.parent[v] = u;
+      }
+    }
+    s.processLate(u);
+  }
+}
+
 template<typename EDGE=GenericEdge, bool DIRECTED=true>
 class GenericGraph
 {
 public:
   using EdgeType=EDGE;
+  static constexpr bool Directed=DIRECTED;
   using VerticeList=std::vector<int>;
   using Flags=std::vector<bool>;
 
   GenericGraph(size_t s): size(s), adjacency(size) {}
   GenericGraph(const GenericGraph& rhs) = default;
 
+  size_t vertices() const
+  {
+    return size;
+  }
+
+  const std::vector<EdgeType>& edges(int u) const
+  {
+    return adjacency[u];
+  }
+
+  // Replaces whole adjacency of u, used by bulk loaders. Undirected graphs are not mirrored.
+  void assign(int u, std::vector<EdgeType>&& edges)
+  {
+    adjacency[u] = std::move(edges);
+  }
+
   template<typename... Args>
   void connect(int u, int v, Args&&... args)
   {
@@ -35,16 +106,26 @@ public:
     }
   }
 
-  void transpose()
+  // Reverses every edge in place keeping its other fields, edges into v end up ordered
+  // by source. Parallel counting sort by target, see countingSort.
+  void transpose(unsigned threads = hardwareThreads())
   {
     if(DIRECTED) {
-      std::vector<EdgeList> aux(size);
-      aux.swap(adjacency);
-      for(int u=0; u<size; ++u) {
-        for(const auto& e: aux[u]) {
-          connect(e.to,u);
+      EdgeList reversed;
+      const auto offsets = countingSort(size, size, [this](size_t begin, size_t end, auto&& emit) {
+        for(size_t u=begin; u<end; ++u) {
+          for(const auto& e: adjacency[u]) {
+            EdgeType r = e;
+            r.to = u;
+            emit(e.to, r);
+          }
         }
-      }
+      }, reversed, threads);
+      parallelFor(threads, size, [&](size_t begin, size_t end, unsigned) {
+        for(size_t v=begin; v<end; ++v) {
+          adjacency[v].assign(reversed.begin() + offsets[v], reversed.begin() + offsets[v+1]);
+        }
+      });
     }
   }
 
@@ -75,48 +156,12 @@ public:
 
   void dfsImpl(int u, TraversalState& s)
   {
-    s.discovered[u] = true;
-    s.processEarly(u);
-
-    for(const EdgeType& e: adjacency[u]) {
-      const int v = e.to;
-      if(!s.discovered[v] && s.validEdge(e)) {
-        s.parent[v] = u;
-        s.processEdge(u,e);
-        dfsImpl(v, s);
-      } else if (!s.processed[v] || DIRECTED) {
-        s.processEdge(u,e);
-      }
-    }
-    s.processLate(u);
-    s.processed[u] = true;
+    depthFirst(*this, u, s);
   }
 
   void bfsImpl(int start, TraversalState& s)
   {
-    std::queue<int> queue;
-    queue.push(start);
-
-    s.discovered[start] = true;
-
-    while(!queue.empty()) {
-      const int u = queue.front();
-      queue.pop();
-      s.processEarly(u);
-      s.processed[u] = true;
-      for(const EdgeType& e: adjacency[u]) {
-        const int v = e.to;
-        if(!s.processed[v] || DIRECTED) {
-          s.processEdge(u,e);
-        }
-        if(!s.discovered[v] && s.validEdge(e)) {
-          queue.push(v);
-          s.discovered[v] = true;
-          s.parent[v] = u;
-        }
-      }
-      s.processLate(u);
-    }
+    breadthFirst(*this, start, s);
   }
 
   VerticeList buildPath(int u, int v, const VerticeList& parent) const
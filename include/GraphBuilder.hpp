@@ -0,0 +1,210 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+#include <CsrGraph.hpp>
+#include <Graph.hpp>
+#include <Parallel.hpp>
+
+namespace algo {
+
+// Edge produced by a loader or generator, value is weight or capacity (1 when there is none)
+struct EdgeRecord
+{
+  int from;
+  int to;
+  int value;
+};
+
+// Edges collected by one thread, batches are concatenated in order
+struct EdgeBatch
+{
+  std::vector<EdgeRecord> edges;
+  long long maxId = -1;
+  long long minId = std::numeric_limits<long long>::max();
+  bool error = false;
+
+  // Ids and values are stored as int, anything beyond is an error of the batch
+  void add(long long u, long long v, long long value)
+  {
+    const long long low = std::numeric_limits<int>::min();
+    const long long high = std::numeric_limits<int>::max();
+    if(u < low || u > high || v < low || v > high || value < low || value > high) {
+      error = true;
+      return;
+    }
+    minId = std::min(minId, std::min(u, v));
+    maxId = std::max(maxId, std::max(u, v));
+    edges.push_back({static_cast<int>(u), static_cast<int>(v), static_cast<int>(value)});
+  }
+};
+
+template<typename E, typename = void>
+struct HasValue: std::false_type {};
+
+template<typename E>
+struct HasValue<E, std::void_t<decltype(E{0, 0})>>: std::true_type {};
+
+template<typename E>
+E makeEdge(int to, int value)
+{
+  if constexpr(HasValue<E>::value) {
+    return E{to, value};
+  } else {
+    return E{to};
+  }
+}
+
+namespace builder {
+
+// Vertices are split into contiguous ranges, one per owner thread. Every batch is
+// scattered into per-owner buckets, so owners later touch only their own vertices.
+struct Partition
+{
+  Partition(size_t n, std::vector<EdgeBatch>& batches, bool mirror, unsigned threads):
+    n(n), owners(std::max(1u, std::min<unsigned>(std::max(1u, threads), std::max<size_t>(n, 1)))),
+    buckets(batches.size(), std::vector<std::vector<EdgeRecord>>(owners))
+  {
+    if(batches.empty()) {
+      return;
+    }
+    std::vector<char> outOfRange(batches.size(), false);
+    parallelRun(batches.size(), [&](unsigned p) {
+      std::vector<size_t> count(owners, 0);
+      for(const auto& e: batches[p].edges) {
+        if(e.from < 0 || static_cast<size_t>(e.from) >= n || e.to < 0 || static_cast<size_t>(e.to) >= n) {
+          outOfRange[p] = true;
+          return;
+        }
+        ++count[owner(e.from)];
+        if(mirror) {
+          ++count[owner(e.to)];
+        }
+      }
+      for(unsigned o=0; o<owners; ++o) {
+        buckets[p][o].reserve(count[o]);
+      }
+      for(const auto& e: batches[p].edges) {
+        buckets[p][owner(e.from)].push_back(e);
+        if(mirror) {
+          buckets[p][owner(e.to)].push_back({e.to, e.from, e.value});
+        }
+      }
+      std::vector<EdgeRecord>().swap(batches[p].edges);
+    });
+    if(std::find(outOfRange.begin(), outOfRange.end(), true) != outOfRange.end()) {
+      throw std::out_of_range("Edge endpoint is not a vertex");
+    }
+  }
+
+  unsigned owner(int u) const
+  {
+    return static_cast<unsigned>(static_cast<unsigned long long>(u)*owners/n);
+  }
+
+  // First vertex of owner o, owner(u) == o exactly for u in [first(o), first(o+1))
+  size_t first(unsigned o) const
+  {
+    return (o*n + owners - 1)/owners;
+  }
+
+  // Calls fn(record) for all edges of owner o, in batch order
+  template<typename F>
+  void scan(unsigned o, F&& fn) const
+  {
+    for(const auto& batch: buckets) {
+      for(const auto& e: batch[o]) {
+        fn(e);
+      }
+    }
+  }
+
+  void release(unsigned o)
+  {
+    for(auto& batch: buckets) {
+      std::vector<EdgeRecord>().swap(batch[o]);
+    }
+  }
+
+  const size_t n;
+  const unsigned owners;
+  std::vector<std::vector<std::vector<EdgeRecord>>> buckets;
+};
+
+} // namespace builder
+
+// Parallel counting sort of edge batches into G. Edges of a vertex keep the batch order,
+// exactly as repeated connect() calls would. Undirected graphs get mirrored edges when
+// mirror is set, inputs listing both directions already should not set it. Throws
+// std::out_of_range if an edge endpoint is not in [0, n).
+template<typename G>
+G buildGraph(size_t n, std::vector<EdgeBatch>& batches, bool mirror, unsigned threads = hardwareThreads())
+{
+  using Edge = typename G::EdgeType;
+  G g(n);
+  if(n == 0) {
+    return g;
+  }
+  builder::Partition partition(n, batches, mirror, threads);
+  parallelRun(partition.owners, [&](unsigned o) {
+    const size_t first = partition.first(o);
+    const size_t last = partition.first(o+1);
+    std::vector<size_t> degree(last - first, 0);
+    partition.scan(o, [&](const EdgeRecord& e) { ++degree[e.from - first]; });
+    std::vector<std::vector<Edge>> lists(last - first);
+    for(size_t i=0; i<lists.size(); ++i) {
+      lists[i].reserve(degree[i]);
+    }
+    partition.scan(o, [&](const EdgeRecord& e) { lists[e.from - first].push_back(makeEdge<Edge>(e.to, e.value)); });
+    partition.release(o);
+    for(size_t i=0; i<lists.size(); ++i) {
+      g.assign(first + i, std::move(lists[i]));
+    }
+  });
+  return g;
+}
+
+// Same as buildGraph, but into a single offsets + edges array pair. Owners count degrees
+// of their ranges, range totals are prefix summed, then every owner scatters its edges.
+template<typename EDGE>
+CsrGraph<EDGE> buildCsr(size_t n, std::vector<EdgeBatch>& batches, bool mirror, unsigned threads = hardwareThreads())
+{
+  std::vector<size_t> offsets(n+1, 0);
+  if(n == 0) {
+    return CsrGraph<EDGE>(std::move(offsets), std::vector<EDGE>());
+  }
+  builder::Partition partition(n, batches, mirror, threads);
+  std::vector<std::vector<size_t>> degrees(partition.owners);
+  std::vector<size_t> base(partition.owners+1, 0);
+  parallelRun(partition.owners, [&](unsigned o) {
+    const size_t first = partition.first(o);
+    degrees[o].assign(partition.first(o+1) - first, 0);
+    partition.scan(o, [&](const EdgeRecord& e) { ++degrees[o][e.from - first]; });
+    for(size_t d: degrees[o]) {
+      base[o+1] += d;
+    }
+  });
+  std::partial_sum(base.begin(), base.end(), base.begin());
+
+  std::vector<EDGE> edges(base[partition.owners]);
+  parallelRun(partition.owners, [&](unsigned o) {
+    const size_t first = partition.first(o);
+    std::vector<size_t> cursor(degrees[o].size());
+    size_t running = base[o];
+    for(size_t i=0; i<cursor.size(); ++i) {
+      cursor[i] = running;
+      running += degrees[o][i];
+      offsets[first+i+1] = running;
+    }
+    partition.scan(o, [&](const EdgeRecord& e) { edges[cursor[e.from - first]++] = makeEdge<EDGE>(e.to, e.value); });
+    partition.release(o);
+  });
+  return CsrGraph<EDGE>(std::move(offsets), std::move(edges));
+}
+
+} // namespace algo
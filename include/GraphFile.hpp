@@ -0,0 +1,240 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <CsrGraph.hpp>
+#include <Graph.hpp>
+
+namespace algo {
+
+// Binary graph layout: header, offsets[vertices+1] (uint64), edges[edges] (packed EDGE
+// records). Edges of vertex u are edges[offsets[u] .. offsets[u+1]). Everything is stored
+// in host byte order with the edge array 8 byte aligned, so it can be used in place.
+struct GraphFileHeader
+{
+  static constexpr char MAGIC[8] = {'A','L','G','O','G','R','P','H'};
+  static constexpr uint32_t VERSION = 1;
+
+  char magic[8];
+  uint32_t version;
+  uint32_t edgeSize;   // sizeof(EDGE), guards against mapping with a wrong edge type
+  uint64_t vertices;
+  uint64_t edges;
+};
+
+template<typename EDGE>
+class GraphFileWriter
+{
+  static_assert(std::is_trivially_copyable<EDGE>::value, "Edge records are written as raw bytes");
+
+public:
+  GraphFileWriter(const std::string& path): _file(path, std::ios::binary | std::ios::trunc)
+  {
+    if(!_file) {
+      throw std::runtime_error("Cannot create graph file " + path);
+    }
+  }
+
+  // Graph provides vertices() and edges(u) as a contiguous range with data() and size()
+  template<typename G>
+  void write(const G& graph)
+  {
+    const size_t n = graph.vertices();
+    std::vector<uint64_t> offsets(n+1, 0);
+    for(size_t u=0; u<n; ++u) {
+      offsets[u+1] = offsets[u] + graph.edges(u).size();
+    }
+
+    GraphFileHeader header;
+    std::memcpy(header.magic, GraphFileHeader::MAGIC, sizeof(header.magic));
+    header.version = GraphFileHeader::VERSION;
+    header.edgeSize = sizeof(EDGE);
+    header.vertices = n;
+    header.edges = offsets[n];
+    put(&header, sizeof(header));
+    put(offsets.data(), offsets.size()*sizeof(uint64_t));
+
+    // Edges are streamed vertex by vertex, no copy of the whole edge array is made
+    for(size_t u=0; u<n; ++u) {
+      const auto& edges = graph.edges(u);
+      put(edges.data(), edges.size()*sizeof(EDGE));
+    }
+    _file.flush();
+    if(!_file) {
+      throw std::runtime_error("Failed writing graph file");
+    }
+  }
+
+private:
+  void put(const void* data, size_t bytes)
+  {
+    _file.write(static_cast<const char*>(data), bytes);
+  }
+
+  std::ofstream _file;
+};
+
+template<typename G>
+void saveGraph(const G& graph, const std::string& path)
+{
+  GraphFileWriter<typename G::EdgeType> writer(path);
+  writer.write(graph);
+}
+
+// Read-only mapping of a whole file, empty files are represented without a mapping
+class MappedFile
+{
+public:
+  MappedFile(const std::string& path)
+  {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+      throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+    }
+    struct stat st;
+    if(::fstat(fd, &st) != 0) {
+      ::close(fd);
+      throw std::runtime_error("Cannot stat " + path + ": " + std::strerror(errno));
+    }
+    _size = st.st_size;
+    if(_size > 0) {
+      void* p = ::mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+      if(p == MAP_FAILED) {
+        ::close(fd);
+        throw std::runtime_error("Cannot map " + path + ": " + std::strerror(errno));
+      }
+      _data = static_cast<const char*>(p);
+    }
+    ::close(fd);
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  MappedFile(MappedFile&& rhs): _data(rhs._data), _size(rhs._size)
+  {
+    rhs._data = nullptr;
+    rhs._size = 0;
+  }
+
+  ~MappedFile()
+  {
+    if(_data) {
+      ::munmap(const_cast<char*>(_data), _size);
+    }
+  }
+
+  const char* data() const
+  {
+    return _data;
+  }
+
+  size_t size() const
+  {
+    return _size;
+  }
+
+  // Whole file is going to be read, fault pages ahead instead of one by one
+  void willNeed() const
+  {
+    if(_data) {
+      ::madvise(const_cast<char*>(_data), _size, MADV_WILLNEED);
+    }
+  }
+
+private:
+  const char* _data = nullptr;
+  size_t _size = 0;
+};
+
+// Read-only CSR view over a memory mapped graph file. Opening costs one mmap call and
+// checks the sizes plus the first and last offset only, pages are faulted in lazily by the
+// kernel as the adjacency is touched. Call validate() on untrusted files, it checks that
+// offsets never decrease and that every edge target is a vertex.
+template<typename EDGE=GenericEdge>
+class MappedGraph
+{
+public:
+  using EdgeType=EDGE;
+
+  MappedGraph(const std::string& path): _file(path)
+  {
+    if(_file.size() < sizeof(GraphFileHeader)) {
+      throw std::runtime_error("Graph file too short: " + path);
+    }
+    const auto* header = reinterpret_cast<const GraphFileHeader*>(_file.data());
+    uint64_t offsetBytes, edgeBytes, expected;
+    const bool overflow = __builtin_add_overflow(header->vertices, 1, &offsetBytes) ||
+      __builtin_mul_overflow(offsetBytes, sizeof(uint64_t), &offsetBytes) ||
+      __builtin_mul_overflow(header->edges, sizeof(EDGE), &edgeBytes) ||
+      __builtin_add_overflow(offsetBytes, edgeBytes, &expected) ||
+      __builtin_add_overflow(expected, sizeof(GraphFileHeader), &expected);
+    if(std::memcmp(header->magic, GraphFileHeader::MAGIC, sizeof(header->magic)) != 0 ||
+       header->version != GraphFileHeader::VERSION || header->edgeSize != sizeof(EDGE) || overflow || expected != _file.size()) {
+      throw std::runtime_error("Invalid graph file " + path);
+    }
+    _size = header->vertices;
+    _offsets = reinterpret_cast<const uint64_t*>(_file.data() + sizeof(GraphFileHeader));
+    _edges = reinterpret_cast<const EDGE*>(_offsets + _size + 1);
+
+    if(_offsets[0] != 0 || _offsets[_size] != header->edges) {
+      throw std::runtime_error("Invalid offsets in graph file " + path);
+    }
+  }
+
+  // Checks offsets never decrease and every edge target is a vertex, reads the whole file
+  void validate() const
+  {
+    for(size_t u=0; u<_size; ++u) {
+      if(_offsets[u] > _offsets[u+1]) {
+        throw std::runtime_error("Decreasing offsets in graph file");
+      }
+    }
+    for(const EDGE* e=_edges; e!=_edges + edgeCount(); ++e) {
+      if(e->to < 0 || static_cast<size_t>(e->to) >= _size) {
+        throw std::runtime_error("Edge target out of range in graph file");
+      }
+    }
+  }
+
+  size_t vertices() const
+  {
+    return _size;
+  }
+
+  size_t edgeCount() const
+  {
+    return _offsets[_size];
+  }
+
+  EdgeRange<EDGE> edges(int u) const
+  {
+    return {_edges + _offsets[u], _edges + _offsets[u+1]};
+  }
+
+  // Hint for whole-graph sweeps
+  void willNeed() const
+  {
+    _file.willNeed();
+  }
+
+private:
+  MappedFile _file;
+  size_t _size = 0;
+  const uint64_t* _offsets = nullptr;
+  const EDGE* _edges = nullptr;
+};
+
+} // namespace algo
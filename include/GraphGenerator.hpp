@@ -0,0 +1,196 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <GraphBuilder.hpp>
+#include <Parallel.hpp>
+
+namespace algo {
+namespace generate {
+
+// Generated edge set, turned into a concrete representation by graph() or csr().
+// Both consume the edges, so call exactly one of them.
+struct EdgeSet
+{
+  size_t vertices;
+  std::vector<EdgeBatch> batches;
+
+  size_t edges() const
+  {
+    size_t m = 0;
+    for(const auto& b: batches) {
+      m += b.edges.size();
+    }
+    return m;
+  }
+
+  // Undirected G gets every generated edge mirrored, as connect() would do
+  template<typename G>
+  G graph(unsigned threads = hardwareThreads())
+  {
+    return buildGraph<G>(vertices, batches, !G::Directed, threads);
+  }
+
+  template<typename EDGE=GenericEdge>
+  CsrGraph<EDGE> csr(unsigned threads = hardwareThreads())
+  {
+    return buildCsr<EDGE>(vertices, batches, false, threads);
+  }
+};
+
+// Work is cut into fixed blocks, each with its own generator seeded by (seed, block).
+// Threads take contiguous block ranges, so the output does not depend on thread count.
+template<typename F>
+EdgeSet generateBlocks(size_t vertices, size_t blocks, unsigned seed, unsigned threads, F&& fn)
+{
+  EdgeSet result{vertices, std::vector<EdgeBatch>(std::max(1u, std::min<unsigned>(std::max(1u, threads), std::max<size_t>(blocks, 1))))};
+  parallelFor(result.batches.size(), blocks, [&](size_t begin, size_t end, unsigned id) {
+    for(size_t block=begin; block<end; ++block) {
+      std::seed_seq seq{seed, static_cast<unsigned>(block), static_cast<unsigned>(block >> 32)};
+      std::mt19937_64 gen(seq);
+      fn(block, gen, result.batches[id]);
+    }
+  });
+  return result;
+}
+
+constexpr size_t BLOCK = 1 << 16;
+
+inline int randomValue(std::mt19937_64& gen, int maxValue)
+{
+  return maxValue > 1 ? std::uniform_int_distribution<int>(1, maxValue)(gen) : 1;
+}
+
+// Recursive matrix (R-MAT) power-law graph on 2^scale vertices with edgeFactor*2^scale
+// edges. Every edge descends scale levels picking quadrant a, b, c or d = 1-a-b-c.
+// a = b = c = 0.25 gives Erdős–Rényi, Graph500 Kronecker uses the defaults.
+inline EdgeSet rmat(int scale, int edgeFactor, unsigned seed, int maxWeight = 1,
+  double a = 0.57, double b = 0.19, double c = 0.19, unsigned threads = hardwareThreads())
+{
+  const size_t n = size_t(1) << scale;
+  const size_t m = n*edgeFactor;
+  // Quadrant is picked by comparing raw 64 bit draws against scaled cumulative thresholds
+  auto threshold = [](double p) {
+    return p >= 1.0 ? std::numeric_limits<uint64_t>::max() : static_cast<uint64_t>(p*18446744073709551616.0);
+  };
+  const uint64_t ta = threshold(a);
+  const uint64_t tab = threshold(a + b);
+  const uint64_t tabc = threshold(a + b + c);
+  return generateBlocks(n, (m + BLOCK - 1)/BLOCK, seed, threads, [&](size_t block, std::mt19937_64& gen, EdgeBatch& out) {
+    const size_t count = std::min(BLOCK, m - block*BLOCK);
+    for(size_t i=0; i<count; ++i) {
+      long long u = 0, v = 0;
+      for(int level=0; level<scale; ++level) {
+        const uint64_t r = gen();
+        u = (u << 1) | (r >= tab);
+        v = (v << 1) | ((r >= ta && r < tab) || r >= tabc);
+      }
+      out.add(u, v, randomValue(gen, maxWeight));
+    }
+  });
+}
+
+// Uniform random G(n, m), self loops excluded, duplicate edges possible
+inline EdgeSet erdosRenyi(size_t n, size_t m, unsigned seed, int maxWeight = 1, unsigned threads = hardwareThreads())
+{
+  return generateBlocks(n, (m + BLOCK - 1)/BLOCK, seed, threads, [&](size_t block, std::mt19937_64& gen, EdgeBatch& out) {
+    std::uniform_int_distribution<long long> node(0, n-1);
+    const size_t count = std::min(BLOCK, m - block*BLOCK);
+    for(size_t i=0; i<count; ) {
+      const long long u = node(gen);
+      const long long v = node(gen);
+      if(u != v) {
+        out.add(u, v, randomValue(gen, maxWeight));
+        ++i;
+      }
+    }
+  });
+}
+
+// rows x cols 4-neighbour grid, vertex r*cols+c. Both directions of a link get
+// independent random weights.
+inline EdgeSet grid(size_t rows, size_t cols, unsigned seed, int maxWeight = 1, unsigned threads = hardwareThreads())
+{
+  return generateBlocks(rows*cols, rows, seed, threads, [&](size_t r, std::mt19937_64& gen, EdgeBatch& out) {
+    for(size_t c=0; c<cols; ++c) {
+      const long long u = r*cols + c;
+      if(c+1 < cols) {
+        out.add(u, u+1, randomValue(gen, maxWeight));
+        out.add(u+1, u, randomValue(gen, maxWeight));
+      }
+      if(r+1 < rows) {
+        out.add(u, u+cols, randomValue(gen, maxWeight));
+        out.add(u+cols, u, randomValue(gen, maxWeight));
+      }
+    }
+  });
+}
+
+// Random DAG with m edges: pairs of distinct ranks i < j give edge order[i] -> order[j],
+// where order is a seeded shuffle, so vertex ids are not already topologically sorted
+inline EdgeSet randomDag(size_t n, size_t m, unsigned seed, unsigned threads = hardwareThreads())
+{
+  std::vector<int> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), std::mt19937_64(seed));
+  return generateBlocks(n, (m + BLOCK - 1)/BLOCK, seed, threads, [&](size_t block, std::mt19937_64& gen, EdgeBatch& out) {
+    std::uniform_int_distribution<long long> node(0, n-1);
+    const size_t count = std::min(BLOCK, m - block*BLOCK);
+    for(size_t i=0; i<count; ) {
+      const long long a = node(gen);
+      const long long b = node(gen);
+      if(a != b) {
+        out.add(order[std::min(a, b)], order[std::max(a, b)], 1);
+        ++i;
+      }
+    }
+  });
+}
+
+// Max-flow network: source 0, layers of width vertices, sink layers*width+1. Source and
+// sink connect to the whole first/last layer, every vertex has degree edges to random
+// vertices of the next layer plus one edge inside its own layer.
+inline EdgeSet layeredFlow(int layers, int width, int degree, int maxCapacity, unsigned seed, unsigned threads = hardwareThreads())
+{
+  const long long n = static_cast<long long>(layers)*width + 2;
+  return generateBlocks(n, layers, seed, threads, [&](size_t l, std::mt19937_64& gen, EdgeBatch& out) {
+    std::uniform_int_distribution<int> node(0, width-1);
+    for(int i=0; i<width; ++i) {
+      const long long u = 1 + l*width + i;
+      if(l == 0) {
+        out.add(0, u, maxCapacity*degree);
+      }
+      if(l+1 < static_cast<size_t>(layers)) {
+        for(int d=0; d<degree; ++d) {
+          out.add(u, 1 + (l+1)*width + node(gen), randomValue(gen, maxCapacity));
+        }
+      } else {
+        out.add(u, n-1, maxCapacity*degree);
+      }
+      out.add(u, 1 + l*width + node(gen), randomValue(gen, maxCapacity));
+    }
+  });
+}
+
+// Random bipartite graph on left + right vertices, edges go from the left ids [0, left)
+// to the right ids [left, left + right) as in BipartiteGraph.
+inline EdgeSet bipartite(size_t left, size_t right, size_t m, unsigned seed, int maxWeight = 1, unsigned threads = hardwareThreads())
+{
+  return generateBlocks(left + right, (m + BLOCK - 1)/BLOCK, seed, threads, [&](size_t block, std::mt19937_64& gen, EdgeBatch& out) {
+    std::uniform_int_distribution<long long> l(0, left-1);
+    std::uniform_int_distribution<long long> r(left, left+right-1);
+    const size_t count = std::min(BLOCK, m - block*BLOCK);
+    for(size_t i=0; i<count; ++i) {
+      const long long u = l(gen);
+      out.add(u, r(gen), randomValue(gen, maxWeight));
+    }
+  });
+}
+
+} // namespace generate
+} // namespace algo
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <CsrGraph.hpp>
+
+namespace algo {
+namespace partition {
+
+// Contiguous vertex ranges, range i is [first[i], first[i+1])
+struct Ranges
+{
+  std::vector<int> first;
+
+  int count() const
+  {
+    return first.size() - 1;
+  }
+
+  int of(int v) const
+  {
+    return std::upper_bound(first.begin() + 1, first.end() - 1, v) - (first.begin() + 1);
+  }
+
+  int begin(int i) const
+  {
+    return first[i];
+  }
+
+  int end(int i) const
+  {
+    return first[i+1];
+  }
+};
+
+// k equal ranges of [0, n)
+inline Ranges even(size_t n, int k)
+{
+  Ranges r;
+  for(int i=0; i<=k; ++i) {
+    r.first.push_back(static_cast<int>(n*i/k));
+  }
+  return r;
+}
+
+// k ranges of [0, n) with about the same vertices + weight(v) each
+template<typename W>
+Ranges balanced(size_t n, int k, W weight)
+{
+  double total = 0;
+  for(size_t v=0; v<n; ++v) {
+    total += 1 + weight(v);
+  }
+  Ranges r;
+  r.first.push_back(0);
+  double sum = 0;
+  for(size_t v=0; v<n && r.first.size() < static_cast<size_t>(k); ++v) {
+    sum += 1 + weight(v);
+    if(sum >= total*r.first.size()/k) {
+      r.first.push_back(v+1);
+    }
+  }
+  while(r.first.size() <= static_cast<size_t>(k)) {
+    r.first.push_back(n);
+  }
+  r.first.back() = n;
+  return r;
+}
+
+// Edges held by one part: sources of one row range, targets of one column range. Local
+// CSR is indexed by source - firstSource, edge targets stay global ids.
+template<typename EDGE>
+struct Part
+{
+  int firstSource;
+  int lastSource;
+  CsrGraph<EDGE> edges;
+
+  EdgeRange<EDGE> out(int u) const
+  {
+    return edges.edges(u - firstSource);
+  }
+};
+
+// Split of a graph over a rows x cols grid of parts, part r*cols + c holds the edges
+// u -> v with u in row range r and v in column range c. Every vertex has one owner
+// keeping its state, the parts of its row hold its out-edges. 1D partitioning is the
+// k x 1 grid: owner and only holder of u are the same part. 2D partitioning bounds the
+// parts a vertex update reaches by cols and the parts an edge endpoint update comes
+// from by rows, instead of k for both.
+template<typename EDGE>
+struct Partitioning
+{
+  int rows;
+  int cols;
+  Ranges owners;
+  Ranges rowRanges;
+  Ranges colRanges;
+  std::vector<Part<EDGE>> parts;
+  size_t vertices;
+
+  int count() const
+  {
+    return rows*cols;
+  }
+
+  int owner(int v) const
+  {
+    return owners.of(v);
+  }
+
+  // Parts holding out-edges of u
+  int firstHolder(int u) const
+  {
+    return rowRanges.of(u)*cols;
+  }
+
+  int lastHolder(int u) const
+  {
+    return firstHolder(u) + cols;
+  }
+};
+
+template<typename EDGE, typename G>
+Partitioning<EDGE> grid(const G& g, const Ranges& owners, const Ranges& rowRanges, const Ranges& colRanges)
+{
+  const int rows = rowRanges.count();
+  const int cols = colRanges.count();
+  const size_t n = g.vertices();
+  std::vector<std::vector<size_t>> offsets(rows*cols);
+  std::vector<std::vector<EDGE>> edges(rows*cols);
+  for(int r=0; r<rows; ++r) {
+    for(int c=0; c<cols; ++c) {
+      offsets[r*cols + c].assign(rowRanges.end(r) - rowRanges.begin(r) + 1, 0);
+    }
+  }
+  for(size_t u=0; u<n; ++u) {
+    const int r = rowRanges.of(u);
+    for(const auto& e: g.edges(u)) {
+      ++offsets[r*cols + colRanges.of(e.to)][u - rowRanges.begin(r) + 1];
+    }
+  }
+  for(int p=0; p<rows*cols; ++p) {
+    for(size_t i=1; i<offsets[p].size(); ++i) {
+      offsets[p][i] += offsets[p][i-1];
+    }
+    edges[p].resize(offsets[p].back());
+  }
+  std::vector<std::vector<size_t>> cursor(offsets);
+  for(size_t u=0; u<n; ++u) {
+    const int r = rowRanges.of(u);
+    for(const auto& e: g.edges(u)) {
+      const int p = r*cols + colRanges.of(e.to);
+      edges[p][cursor[p][u - rowRanges.begin(r)]++] = e;
+    }
+  }
+
+  Partitioning<EDGE> result{rows, cols, owners, rowRanges, colRanges, {}, n};
+  for(int p=0; p<rows*cols; ++p) {
+    const int r = p / cols;
+    result.parts.push_back({rowRanges.begin(r), rowRanges.end(r), CsrGraph<EDGE>(std::move(offsets[p]), std::move(edges[p]))});
+  }
+  return result;
+}
+
+// 1D: k vertex ranges with balanced vertices + out-edges, each part owns a range and
+// all out-edges of it
+template<typename G>
+Partitioning<typename G::EdgeType> oneD(const G& g, int k)
+{
+  if(k < 1 || static_cast<size_t>(k) > std::max<size_t>(g.vertices(), 1)) {
+    throw std::invalid_argument("Bad part count");
+  }
+  const Ranges ranges = balanced(g.vertices(), k, [&g](int v) { return g.edges(v).size(); });
+  return grid<typename G::EdgeType>(g, ranges, ranges, even(g.vertices(), 1));
+}
+
+// 2D: rows x cols grid of edge blocks, vertices owned by k even ranges
+template<typename G>
+Partitioning<typename G::EdgeType> twoD(const G& g, int rows, int cols)
+{
+  const size_t n = g.vertices();
+  if(rows < 1 || cols < 1 || static_cast<size_t>(rows*cols) > std::max<size_t>(n, 1)) {
+    throw std::invalid_argument("Bad grid size");
+  }
+  return grid<typename G::EdgeType>(g, even(n, rows*cols), even(n, rows), even(n, cols));
+}
+
+// Most square grid with k parts
+template<typename G>
+Partitioning<typename G::EdgeType> twoD(const G& g, int k)
+{
+  if(k < 1) {
+    throw std::invalid_argument("Bad grid size");
+  }
+  int rows = static_cast<int>(std::sqrt(static_cast<double>(k)));
+  while(k % rows) {
+    --rows;
+  }
+  return twoD(g, rows, k / rows);
+}
+
+} // namespace partition
+} // namespace algo
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Graph.hpp>
+#include <GraphBuilder.hpp>
+#include <GraphFile.hpp>
+#include <Parallel.hpp>
+
+namespace algo {
+namespace reader {
+
+// Start of the first line beginning at or after pos. memchr is vectorised by libc,
+// so boundary and newline scans run at memory speed.
+inline const char* lineStart(const char* begin, const char* end, const char* pos)
+{
+  if(pos <= begin) {
+    return begin;
+  }
+  if(pos >= end) {
+    return end;
+  }
+  const void* nl = std::memchr(pos-1, '\n', end-pos+1);
+  return nl ? static_cast<const char*>(nl) + 1 : end;
+}
+
+inline const char* lineEnd(const char* pos, const char* end)
+{
+  const void* nl = std::memchr(pos, '\n', end-pos);
+  return nl ? static_cast<const char*>(nl) : end;
+}
+
+inline void skipBlanks(const char*& p, const char* end)
+{
+  while(p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+    ++p;
+  }
+}
+
+// Reads next decimal integer of the line, false if the line is exhausted or malformed.
+// Numbers out of the long long range are malformed, p is then left at their first digit.
+inline bool nextInt(const char*& p, const char* end, long long& value)
+{
+  skipBlanks(p, end);
+  const char* start = p;
+  if(p == end) {
+    return false;
+  }
+  bool negative = false;
+  if(*p == '-' || *p == '+') {
+    negative = *p == '-';
+    ++p;
+  }
+  if(p == end || *p < '0' || *p > '9') {
+    p = start;
+    return false;
+  }
+  long long v = 0;
+  while(p < end && *p >= '0' && *p <= '9') {
+    if(__builtin_mul_overflow(v, 10, &v) || __builtin_add_overflow(v, *p++ - '0', &v)) {
+      p = start;
+      return false;
+    }
+  }
+  value = negative ? -v : v;
+  return true;
+}
+
+// Calls fn(lineBegin, lineEnd, chunk, id) for every line of [begin, end), split into
+// count chunks at line boundaries and processed in parallel
+template<typename F>
+std::vector<EdgeBatch> parseLines(const char* begin, const char* end, unsigned count, F&& fn)
+{
+  count = std::max(1u, count);
+  std::vector<EdgeBatch> chunks(count);
+  const size_t size = end - begin;
+  parallelRun(count, [&](unsigned id) {
+    const char* first = lineStart(begin, end, begin + size*id/count);
+    const char* last = lineStart(begin, end, begin + size*(id+1)/count);
+    for(const char* p=first; p<last; ) {
+      const char* e = lineEnd(p, last);
+      fn(p, e, chunks[id], id);
+      p = e + 1;
+    }
+  });
+  return chunks;
+}
+
+inline void checkBatches(const std::vector<EdgeBatch>& batches, long long n, const std::string& path)
+{
+  for(const auto& c: batches) {
+    if(c.error) {
+      throw std::runtime_error("Malformed line in " + path);
+    }
+    if(c.maxId >= n || (c.maxId >= 0 && c.minId < 0)) {
+      throw std::runtime_error("Vertex id out of range in " + path);
+    }
+  }
+}
+
+} // namespace reader
+
+template<typename G>
+struct DimacsGraph
+{
+  G graph;
+  int source;  // -1 unless given by "n <id> s" line
+  int sink;    // -1 unless given by "n <id> t" line
+};
+
+// Whitespace separated "u v [value]" lines with 0-based ids. Lines starting with # or %
+// are comments. Vertex count is the largest id + 1.
+template<typename G>
+G readEdgeList(const std::string& path, unsigned threads = hardwareThreads())
+{
+  using namespace reader;
+  MappedFile file(path);
+  file.willNeed();
+  auto chunks = parseLines(file.data(), file.data() + file.size(), threads,
+    [](const char* p, const char* end, EdgeBatch& c, unsigned) {
+      skipBlanks(p, end);
+      if(p == end || *p == '#' || *p == '%') {
+        return;
+      }
+      long long u, v, value = 1;
+      if(!nextInt(p, end, u) || !nextInt(p, end, v)) {
+        c.error = true;
+        return;
+      }
+      nextInt(p, end, value);
+      skipBlanks(p, end);
+      if(p != end) {
+        c.error = true;
+        return;
+      }
+      c.add(u, v, value);
+    });
+  long long n = 0;
+  for(const auto& c: chunks) {
+    n = std::max(n, c.maxId + 1);
+  }
+  checkBatches(chunks, n, path);
+  return buildGraph<G>(n, chunks, !G::Directed, threads);
+}
+
+// DIMACS shortest path ("p sp") and max flow ("p max") files: "a u v value" arcs with
+// 1-based ids, "n id s|t" designate source and sink, "c" lines are comments
+template<typename G>
+DimacsGraph<G> readDimacs(const std::string& path, unsigned threads = hardwareThreads())
+{
+  using namespace reader;
+  MappedFile file(path);
+  file.willNeed();
+  std::vector<long long> vertices(std::max(1u, threads), -1);
+  std::vector<long long> source(vertices.size(), -1);
+  std::vector<long long> sink(vertices.size(), -1);
+  auto chunks = parseLines(file.data(), file.data() + file.size(), threads,
+    [&](const char* p, const char* end, EdgeBatch& c, unsigned id) {
+      skipBlanks(p, end);
+      if(p == end) {
+        return;
+      }
+      const char kind = *p++;
+      long long u, v, value;
+      if(kind == 'a') {
+        if(!nextInt(p, end, u) || !nextInt(p, end, v) || !nextInt(p, end, value)) {
+          c.error = true;
+          return;
+        }
+        c.add(u-1, v-1, value);
+      } else if(kind == 'p') {
+        skipBlanks(p, end);
+        while(p < end && *p != ' ' && *p != '\t') {
+          ++p;
+        }
+        if(!nextInt(p, end, vertices[id])) {
+          c.error = true;
+        }
+      } else if(kind == 'n') {
+        skipBlanks(p, end);
+        if(!nextInt(p, end, u)) {
+          c.error = true;
+          return;
+        }
+        skipBlanks(p, end);
+        if(p < end && *p == 's') {
+          source[id] = u-1;
+        } else if(p < end && *p == 't') {
+          sink[id] = u-1;
+        }
+      } else if(kind != 'c') {
+        c.error = true;
+      }
+    });
+
+  long long n = -1, s = -1, t = -1;
+  for(size_t i=0; i<vertices.size(); ++i) {
+    n = std::max(n, vertices[i]);
+    s = std::max(s, source[i]);
+    t = std::max(t, sink[i]);
+  }
+  if(n < 0) {
+    throw std::runtime_error("Missing problem line in " + path);
+  }
+  checkBatches(chunks, n, path);
+  return {buildGraph<G>(n, chunks, !G::Directed, threads), static_cast<int>(s), static_cast<int>(t)};
+}
+
+// METIS graph file: header "n m [fmt [ncon]]", then line i lists 1-based neighbours of
+// vertex i, optionally preceded by vertex size/weights and followed by edge weights as
+// selected by fmt. Every undirected edge is listed from both sides, so it is never mirrored.
+template<typename G>
+G readMetis(const std::string& path, unsigned threads = hardwareThreads())
+{
+  using namespace reader;
+  MappedFile file(path);
+  file.willNeed();
+  const char* p = file.data();
+  const char* end = file.data() + file.size();
+
+  const char* header = p;
+  const char* headerEnd = lineEnd(p, end);
+  while(header < end && *header == '%') {
+    header = headerEnd + 1;
+    headerEnd = header < end ? lineEnd(header, end) : end;
+  }
+  long long n, m, fmt = 0, ncon = 1;
+  const char* h = header;
+  if(header >= end || !nextInt(h, headerEnd, n) || !nextInt(h, headerEnd, m)) {
+    throw std::runtime_error("Missing METIS header in " + path);
+  }
+  nextInt(h, headerEnd, fmt);
+  nextInt(h, headerEnd, ncon);
+  const bool hasSize = fmt / 100 % 10 == 1;
+  const int vertexValues = (fmt / 10 % 10 == 1 ? ncon : 0) + (hasSize ? 1 : 0);
+  const bool hasWeights = fmt % 10 == 1;
+
+  const char* body = std::min(end, headerEnd + 1);
+  const unsigned count = std::max(1u, threads);
+  const size_t size = end - body;
+
+  // First pass numbers the lines: vertex of a line is its index among non-comment lines
+  std::vector<long long> first(count+1, 0);
+  parallelRun(count, [&](unsigned id) {
+    const char* b = lineStart(body, end, body + size*id/count);
+    const char* e = lineStart(body, end, body + size*(id+1)/count);
+    long long lines = 0;
+    for(const char* q=b; q<e; q=lineEnd(q, e)+1) {
+      lines += *q != '%';
+    }
+    first[id+1] = lines;
+  });
+  std::partial_sum(first.begin(), first.end(), first.begin());
+
+  std::vector<long long> vertex(first.begin(), first.end()-1);
+  auto chunks = parseLines(body, end, count,
+    [&](const char* q, const char* e, EdgeBatch& c, unsigned id) {
+      if(q < e && *q == '%') {
+        return;
+      }
+      const long long u = vertex[id]++;
+      if(u >= n) {
+        return;
+      }
+      long long v, value = 1;
+      for(int i=0; i<vertexValues; ++i) {
+        if(!nextInt(q, e, v)) {
+          c.error = true;
+          return;
+        }
+      }
+      while(nextInt(q, e, v)) {
+        if(hasWeights && !nextInt(q, e, value)) {
+          c.error = true;
+          return;
+        }
+        c.add(u, v-1, value);
+      }
+      skipBlanks(q, e);
+      c.error |= q != e;
+    });
+  checkBatches(chunks, n, path);
+  return buildGraph<G>(n, chunks, false, threads);
+}
+
+} // namespace algo
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include <CsrGraph.hpp>
+#include <Graph.hpp>
+#include <Parallel.hpp>
+
+namespace algo {
+namespace reorder {
+
+// permutation[old] = new vertex id
+using Permutation = std::vector<int>;
+
+inline Permutation inverse(const Permutation& p)
+{
+  Permutation result(p.size());
+  for(size_t u=0; u<p.size(); ++u) {
+    result[p[u]] = u;
+  }
+  return result;
+}
+
+// Turns a visiting sequence (new id -> old id) into a permutation
+inline Permutation fromSequence(const std::vector<int>& sequence)
+{
+  return inverse(sequence);
+}
+
+inline Permutation randomOrder(size_t n, unsigned seed)
+{
+  Permutation p(n);
+  std::iota(p.begin(), p.end(), 0);
+  std::shuffle(p.begin(), p.end(), std::mt19937(seed));
+  return p;
+}
+
+// Highest degree first, hubs and their adjacency end up packed at the start of arrays
+template<typename G>
+Permutation degreeOrder(const G& g)
+{
+  std::vector<int> sequence(g.vertices());
+  std::iota(sequence.begin(), sequence.end(), 0);
+  std::stable_sort(sequence.begin(), sequence.end(), [&g](int u, int v) {
+    return g.edges(u).size() > g.edges(v).size();
+  });
+  return fromSequence(sequence);
+}
+
+// Reverse Cuthill-McKee: BFS from a minimum degree vertex of every component, neighbours
+// visited in increasing degree, final sequence reversed. Keeps the adjacency matrix
+// bandwidth small, so neighbours get nearby ids. Directed graphs are followed along out
+// edges only, which is still a good order when most edges have a reverse.
+template<typename G>
+Permutation reverseCuthillMcKee(const G& g)
+{
+  const size_t n = g.vertices();
+  std::vector<int> byDegree(n);
+  std::iota(byDegree.begin(), byDegree.end(), 0);
+  std::stable_sort(byDegree.begin(), byDegree.end(), [&g](int u, int v) {
+    return g.edges(u).size() < g.edges(v).size();
+  });
+
+  std::vector<bool> visited(n, false);
+  std::vector<int> sequence;
+  sequence.reserve(n);
+  std::vector<int> neighbours;
+  for(int root: byDegree) {
+    if(visited[root]) {
+      continue;
+    }
+    visited[root] = true;
+    size_t head = sequence.size();
+    sequence.push_back(root);
+    while(head < sequence.size()) {
+      const int u = sequence[head++];
+      neighbours.clear();
+      for(const auto& e: g.edges(u)) {
+        if(!visited[e.to]) {
+          visited[e.to] = true;
+          neighbours.push_back(e.to);
+        }
+      }
+      std::stable_sort(neighbours.begin(), neighbours.end(), [&g](int a, int b) {
+        return g.edges(a).size() < g.edges(b).size();
+      });
+      sequence.insert(sequence.end(), neighbours.begin(), neighbours.end());
+    }
+  }
+  std::reverse(sequence.begin(), sequence.end());
+  return fromSequence(sequence);
+}
+
+// Gorder (Wei et al.): greedily appends the vertex with the largest locality score to the
+// last window vertices. Score counts edges to the window and in-neighbours shared with it.
+// Like the original, vertices with degree above sqrt(n) are not expanded, and the
+// max-score vertex is found through a lazily updated heap instead of a unit heap.
+template<typename G>
+Permutation gorder(const G& g, int window = 5)
+{
+  const int n = g.vertices();
+  std::vector<size_t> inOffset(n+1, 0);
+  for(int u=0; u<n; ++u) {
+    for(const auto& e: g.edges(u)) {
+      ++inOffset[e.to+1];
+    }
+  }
+  std::partial_sum(inOffset.begin(), inOffset.end(), inOffset.begin());
+  std::vector<int> in(inOffset[n]);
+  std::vector<size_t> pos(inOffset.begin(), inOffset.end()-1);
+  for(int u=0; u<n; ++u) {
+    for(const auto& e: g.edges(u)) {
+      in[pos[e.to]++] = u;
+    }
+  }
+  const size_t hub = static_cast<size_t>(std::sqrt(static_cast<double>(n))) + 1;
+
+  std::vector<int> score(n, 0);
+  std::vector<bool> placed(n, false);
+  using Item = std::pair<int, int>;
+  std::priority_queue<Item> heap;
+
+  auto update = [&](int v, int delta) {
+    if(!placed[v]) {
+      score[v] += delta;
+      if(score[v] > 0) {
+        heap.push({score[v], v});
+      }
+    }
+  };
+  // Adds (delta 1) or removes (delta -1) contribution of window vertex u. Siblings are
+  // not expanded through hubs, neither when u itself has more than sqrt(n) in-neighbours.
+  auto touch = [&](int u, int delta) {
+    for(const auto& e: g.edges(u)) {
+      update(e.to, delta);
+    }
+    const bool expand = inOffset[u+1] - inOffset[u] <= hub;
+    for(size_t i=inOffset[u]; i<inOffset[u+1]; ++i) {
+      const int w = in[i];
+      update(w, delta);
+      if(expand && g.edges(w).size() <= hub) {
+        for(const auto& e: g.edges(w)) {
+          if(e.to != u) {
+            update(e.to, delta);
+          }
+        }
+      }
+    }
+    // Stale entries are dropped once they outnumber vertices, which bounds heap memory
+    if(heap.size() > 4*static_cast<size_t>(n) + 64) {
+      std::vector<Item> live;
+      for(int v=0; v<n; ++v) {
+        if(!placed[v] && score[v] > 0) {
+          live.push_back({score[v], v});
+        }
+      }
+      heap = std::priority_queue<Item>(std::less<Item>(), std::move(live));
+    }
+  };
+
+  std::vector<int> byDegree(n);
+  std::iota(byDegree.begin(), byDegree.end(), 0);
+  std::stable_sort(byDegree.begin(), byDegree.end(), [&](int u, int v) {
+    return inOffset[u+1] - inOffset[u] > inOffset[v+1] - inOffset[v];
+  });
+  size_t next = 0;
+
+  std::vector<int> sequence;
+  sequence.reserve(n);
+  while(static_cast<int>(sequence.size()) < n) {
+    int u = -1;
+    while(!heap.empty()) {
+      const auto [s, v] = heap.top();
+      heap.pop();
+      if(!placed[v] && s == score[v] && s > 0) {
+        u = v;
+        break;
+      }
+    }
+    if(u < 0) {
+      // Nothing related to the window, continue with the next unplaced high in-degree vertex
+      while(placed[byDegree[next]]) {
+        ++next;
+      }
+      u = byDegree[next];
+    }
+    placed[u] = true;
+    sequence.push_back(u);
+    touch(u, 1);
+    if(static_cast<int>(sequence.size()) > window) {
+      touch(sequence[sequence.size() - window - 1], -1);
+    }
+  }
+  return fromSequence(sequence);
+}
+
+// Copy of g with vertex u renamed to p[u], adjacency order and edge fields preserved
+template<typename G>
+G relabel(const G& g, const Permutation& p, unsigned threads = hardwareThreads())
+{
+  using Edge = typename G::EdgeType;
+  G result(g.vertices());
+  parallelFor(threads, g.vertices(), [&](size_t begin, size_t end, unsigned) {
+    for(size_t u=begin; u<end; ++u) {
+      std::vector<Edge> edges(g.edges(u).begin(), g.edges(u).end());
+      for(auto& e: edges) {
+        e.to = p[e.to];
+      }
+      result.assign(p[u], std::move(edges));
+    }
+  });
+  return result;
+}
+
+template<typename EDGE>
+CsrGraph<EDGE> relabel(const CsrGraph<EDGE>& g, const Permutation& p, unsigned threads = hardwareThreads())
+{
+  const size_t n = g.vertices();
+  const Permutation old = inverse(p);
+  std::vector<size_t> offsets(n+1, 0);
+  for(size_t v=0; v<n; ++v) {
+    offsets[v+1] = offsets[v] + g.edges(old[v]).size();
+  }
+  std::vector<EDGE> edges(g.edgeCount());
+  parallelFor(threads, n, [&](size_t begin, size_t end, unsigned) {
+    for(size_t v=begin; v<end; ++v) {
+      size_t i = offsets[v];
+      for(auto e: g.edges(old[v])) {
+        e.to = p[e.to];
+        edges[i++] = e;
+      }
+    }
+  });
+  return CsrGraph<EDGE>(std::move(offsets), std::move(edges));
+}
+
+// Per-vertex results computed on the relabelled graph, indexed by original ids again
+template<typename T>
+std::vector<T> restore(const std::vector<T>& values, const Permutation& p)
+{
+  std::vector<T> result(values.size());
+  for(size_t u=0; u<p.size(); ++u) {
+    result[u] = values[p[u]];
+  }
+  return result;
+}
+
+// Same for results holding vertex ids (parents, components), negative ids are kept
+inline std::vector<int> restoreIds(const std::vector<int>& ids, const Permutation& p)
+{
+  const Permutation old = inverse(p);
+  std::vector<int> result = restore(ids, p);
+  for(int& v: result) {
+    if(v >= 0) {
+      v = old[v];
+    }
+  }
+  return result;
+}
+
+// Average |new(u) - new(v)| over all edges, lower means better locality
+template<typename G>
+double averageGap(const G& g, const Permutation& p)
+{
+  double total = 0;
+  size_t edges = 0;
+  for(size_t u=0; u<g.vertices(); ++u) {
+    for(const auto& e: g.edges(u)) {
+      total += std::abs(p[u] - p[e.to]);
+      ++edges;
+    }
+  }
+  return edges ? total / edges : 0.0;
+}
+
+} // namespace reorder
+} // namespace algo
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <iostream>
+#include <stdexcept>
 #include <vector>
 
 namespace algo {
 
+// Dense matrix stored contiguously in row-major order
 template<typename T>
 class Matrix
 {
@@ -15,34 +17,39 @@ public:
     _h(h), 
     _w(w), 
     _col(h, init), 
-    _m(h, Array(w, init))
+    _m(h*w, init)
   {}
 
   Matrix(const Matrix& rhs) = default;
 
   T& operator()(size_t i, size_t j)
   {
-    return _m.at(i).at(j);
+    return _m.at(index(i, j));
   }
 
   const T& operator()(size_t i, size_t j) const
   {
-    return _m.at(i).at(j);
+    return _m.at(index(i, j));
   }
 
-  const Array& row(size_t i) const
+  const T* row(size_t i) const
   {
-    return _m.at(i);
+    return &_m.at(index(i, 0));
   }
 
   const Array& column(size_t j) const
   {
     for(int i=0; i<_h; ++i) {
-      _col[i] = _m[i].at(j);
+      _col[i] = _m[index(i, j)];
     }
     return _col;
   }
 
+  const T* data() const
+  {
+    return _m.data();
+  }
+
   size_t height() const
   {
     return _h;
@@ -54,10 +61,18 @@ public:
   }
 
 private:
+  size_t index(size_t i, size_t j) const
+  {
+    if(j >= _w) {
+      throw std::out_of_range("Matrix column out of range");
+    }
+    return i*_w + j;
+  }
+
   const size_t _h;
   const size_t _w;
   mutable Array _col;
-  std::vector<Array> _m;
+  Array _m;
 };
 
 } // namespace algo
@@ -72,4 +87,4 @@ std::ostream& operator<<(std::ostream& strm, const algo::Matrix<T>& m)
     strm << std::endl;
   }
   return strm;
-}
\ No newline at end of file
+}
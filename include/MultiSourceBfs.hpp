@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <Graph.hpp>
+#include <Parallel.hpp>
+
+namespace algo {
+
+// Set of up to 64*WORDS BFS sources. Operations are plain loops over the words, which
+// compilers turn into vector OR / AND-NOT.
+template<size_t WORDS>
+struct SourceSet
+{
+  static constexpr size_t Capacity = 64*WORDS;
+
+  std::array<uint64_t, WORDS> words{};
+
+  void set(size_t i)
+  {
+    words[i >> 6] |= uint64_t(1) << (i & 63);
+  }
+
+  bool test(size_t i) const
+  {
+    return (words[i >> 6] >> (i & 63)) & 1;
+  }
+
+  bool any() const
+  {
+    uint64_t x = 0;
+    for(size_t w=0; w<WORDS; ++w) {
+      x |= words[w];
+    }
+    return x != 0;
+  }
+
+  SourceSet& operator|=(const SourceSet& rhs)
+  {
+    for(size_t w=0; w<WORDS; ++w) {
+      words[w] |= rhs.words[w];
+    }
+    return *this;
+  }
+
+  // this &= ~rhs
+  SourceSet& remove(const SourceSet& rhs)
+  {
+    for(size_t w=0; w<WORDS; ++w) {
+      words[w] &= ~rhs.words[w];
+    }
+    return *this;
+  }
+
+  // Calls fn(i) for every source i of the set
+  template<typename F>
+  void forEach(F&& fn) const
+  {
+    for(size_t w=0; w<WORDS; ++w) {
+      for(uint64_t x=words[w]; x; x &= x - 1) {
+        fn(w*64 + __builtin_ctzll(x));
+      }
+    }
+  }
+};
+
+// MS-BFS (Then et al.): one traversal for up to 64*WORDS sources. Every vertex keeps the
+// set of sources that have seen it and the set reaching it in the current level, so one
+// scan of an adjacency list advances all sources whose frontier contains the vertex.
+// visit(v, sources, depth) is called once per level for every vertex newly reached,
+// sources being the set of batch indices which reached it at that depth.
+template<size_t WORDS = 4, typename G, typename Visit>
+void multiSourceBfs(const G& g, const std::vector<int>& sources, Visit&& visit)
+{
+  using Set = SourceSet<WORDS>;
+  if(sources.size() > Set::Capacity) {
+    throw std::invalid_argument("Too many sources for one batch");
+  }
+  const size_t n = g.vertices();
+  std::vector<Set> seen(n), frontier(n), next(n);
+  for(size_t i=0; i<sources.size(); ++i) {
+    seen[sources[i]].set(i);
+    frontier[sources[i]].set(i);
+  }
+  for(size_t v=0; v<n; ++v) {
+    if(frontier[v].any()) {
+      visit(static_cast<int>(v), frontier[v], 0);
+    }
+  }
+
+  for(int depth=1; ; ++depth) {
+    for(size_t v=0; v<n; ++v) {
+      if(!frontier[v].any()) {
+        continue;
+      }
+      for(const auto& e: g.edges(v)) {
+        next[e.to] |= frontier[v];
+      }
+    }
+    bool active = false;
+    for(size_t v=0; v<n; ++v) {
+      frontier[v] = Set();
+      if(!next[v].any()) {
+        continue;
+      }
+      next[v].remove(seen[v]);
+      if(next[v].any()) {
+        seen[v] |= next[v];
+        visit(static_cast<int>(v), next[v], depth);
+        frontier[v] = next[v];
+        active = true;
+      }
+      next[v] = Set();
+    }
+    if(!active) {
+      return;
+    }
+  }
+}
+
+// Hop distances, result[i][v] from sources[i], -1 when unreachable. Sources are cut in
+// batches of 64*WORDS, batches are spread over threads.
+template<size_t WORDS = 4, typename G>
+std::vector<std::vector<int>> hopDistances(const G& g, const std::vector<int>& sources, unsigned threads = hardwareThreads())
+{
+  constexpr size_t BATCH = SourceSet<WORDS>::Capacity;
+  std::vector<std::vector<int>> result(sources.size(), std::vector<int>(g.vertices(), -1));
+  const size_t batches = (sources.size() + BATCH - 1) / BATCH;
+  parallelFor(threads, batches, [&](size_t begin, size_t end, unsigned) {
+    for(size_t b=begin; b<end; ++b) {
+      const size_t first = b*BATCH;
+      const std::vector<int> batch(sources.begin() + first, sources.begin() + std::min(sources.size(), first + BATCH));
+      multiSourceBfs<WORDS>(g, batch, [&](int v, const SourceSet<WORDS>& reached, int depth) {
+        reached.forEach([&](size_t i) { result[first + i][v] = depth; });
+      });
+    }
+  });
+  return result;
+}
+
+} // namespace algo
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace algo {
+
+// Pool of fixed size nodes addressed by 32 bit ids. Nodes are carved out of slabs of
+// 2^SLAB_BITS nodes which never move, so references stay valid while the pool grows.
+// Freed ids are reused before the pool grows. Over-aligned NODE types (alignas(64)) get
+// cache line aligned slots.
+template<typename NODE, int SLAB_BITS = 10>
+class NodeArena
+{
+public:
+  using Id = uint32_t;
+  static constexpr Id NONE = ~Id(0);
+
+  NodeArena() = default;
+  NodeArena(const NodeArena&) = delete;
+  NodeArena& operator=(const NodeArena&) = delete;
+  NodeArena(NodeArena&&) = default;
+  NodeArena& operator=(NodeArena&&) = default;
+
+  // Default constructed node
+  Id allocate()
+  {
+    if(!_free.empty()) {
+      const Id id = _free.back();
+      _free.pop_back();
+      (*this)[id] = NODE();
+      return id;
+    }
+    if((_used >> SLAB_BITS) == _slabs.size()) {
+      _slabs.emplace_back(new NODE[SLAB]);
+    }
+    return _used++;
+  }
+
+  void release(Id id)
+  {
+    _free.push_back(id);
+  }
+
+  // Room for n more nodes without allocating slabs on the way
+  void reserve(size_t n)
+  {
+    while((_slabs.size() << SLAB_BITS) < _used + n) {
+      _slabs.emplace_back(new NODE[SLAB]);
+    }
+  }
+
+  NODE& operator[](Id id)
+  {
+    return _slabs[id >> SLAB_BITS][id & (SLAB - 1)];
+  }
+
+  const NODE& operator[](Id id) const
+  {
+    return _slabs[id >> SLAB_BITS][id & (SLAB - 1)];
+  }
+
+  // Nodes in use
+  size_t size() const
+  {
+    return _used - _free.size();
+  }
+
+  size_t memory() const
+  {
+    return _slabs.size()*SLAB*sizeof(NODE) + _free.capacity()*sizeof(Id);
+  }
+
+  void clear()
+  {
+    _slabs.clear();
+    _free.clear();
+    _used = 0;
+  }
+
+private:
+  static constexpr size_t SLAB = size_t(1) << SLAB_BITS;
+
+  std::vector<std::unique_ptr<NODE[]>> _slabs;
+  std::vector<Id> _free;
+  size_t _used = 0;
+};
+
+} // namespace algo
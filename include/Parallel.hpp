@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace algo {
+
+inline unsigned hardwareThreads()
+{
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Reusable rendezvous point for a fixed group of threads
+class Barrier
+{
+public:
+  Barrier(unsigned count): _count(count), _waiting(0), _generation(0) {}
+
+  void wait()
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    const unsigned generation = _generation;
+    if(++_waiting == _count) {
+      _waiting = 0;
+      ++_generation;
+      _cv.notify_all();
+    } else {
+      _cv.wait(lock, [this, generation] { return generation != _generation; });
+    }
+  }
+
+private:
+  const unsigned _count;
+  unsigned _waiting;
+  unsigned _generation;
+  std::mutex _mutex;
+  std::condition_variable _cv;
+};
+
+// Runs fn(id) on threads 0..count-1, the calling thread acts as thread 0. A count of 0
+// runs fn(0) alone.
+template<typename F>
+void parallelRun(unsigned count, F&& fn)
+{
+  count = std::max(1u, count);
+  std::vector<std::thread> workers;
+  workers.reserve(count-1);
+  for(unsigned id=1; id<count; ++id) {
+    workers.emplace_back([&fn, id] { fn(id); });
+  }
+  fn(0);
+  for(auto& w: workers) {
+    w.join();
+  }
+}
+
+// Splits [0, n) into contiguous blocks, fn(begin, end, id) is called once per thread
+template<typename F>
+void parallelFor(unsigned count, size_t n, F&& fn)
+{
+  count = std::max(1u, std::min<unsigned>(count, std::max<size_t>(n, 1)));
+  parallelRun(count, [&](unsigned id) {
+    const size_t begin = n*id/count;
+    const size_t end = n*(id+1)/count;
+    fn(begin, end, id);
+  });
+}
+
+// Stable parallel counting sort into keys [0, keys). [0, n) is split into one block per
+// thread, produce(begin, end, emit) calls emit(key, item) for the items of a block. It runs
+// twice, to count and to scatter, and has to emit the same sequence both times. Items of
+// key k end up in out[offsets[k] .. offsets[k+1]) in emission order over [0, n), so the
+// result does not depend on the thread count. Keys are split into one range per thread:
+// blocks count per range and stage their items range by range, then every thread counts
+// and places the items of its own range. Memory traffic is a few sequential passes.
+template<typename T, typename F>
+std::vector<size_t> countingSort(size_t n, size_t keys, F&& produce, std::vector<T>& out, unsigned threads = hardwareThreads())
+{
+  std::vector<size_t> offsets(keys+1, 0);
+  out.clear();
+  if(keys == 0) {
+    return offsets;
+  }
+  const unsigned blocks = std::max(1u, std::min<unsigned>(threads, std::max<size_t>(n, 1)));
+  const unsigned ranges = std::max(1u, std::min<unsigned>(threads, keys));
+  auto range = [&](size_t key) { return static_cast<unsigned>(key*ranges/keys); };
+  auto first = [&](unsigned r) { return (r*keys + ranges - 1)/ranges; };
+
+  std::vector<std::vector<size_t>> cursor(blocks, std::vector<size_t>(ranges, 0));
+  parallelFor(blocks, n, [&](size_t begin, size_t end, unsigned id) {
+    produce(begin, end, [&](size_t key, const T&) { ++cursor[id][range(key)]; });
+  });
+  std::vector<size_t> start(ranges+1, 0);
+  for(unsigned r=0; r<ranges; ++r) {
+    start[r+1] = start[r];
+    for(unsigned b=0; b<blocks; ++b) {
+      const size_t count = cursor[b][r];
+      cursor[b][r] = start[r+1];
+      start[r+1] += count;
+    }
+  }
+
+  std::vector<size_t> stagedKeys(start[ranges]);
+  std::vector<T> staged(start[ranges]);
+  parallelFor(blocks, n, [&](size_t begin, size_t end, unsigned id) {
+    produce(begin, end, [&](size_t key, const T& item) {
+      const size_t i = cursor[id][range(key)]++;
+      stagedKeys[i] = key;
+      staged[i] = item;
+    });
+  });
+
+  out.resize(start[ranges]);
+  parallelRun(ranges, [&](unsigned r) {
+    const size_t low = first(r);
+    const size_t high = first(r+1);
+    std::vector<size_t> position(high - low + 1, 0);
+    for(size_t i=start[r]; i<start[r+1]; ++i) {
+      ++position[stagedKeys[i] - low + 1];
+    }
+    position[0] = start[r];
+    for(size_t k=low; k<high; ++k) {
+      position[k - low + 1] += position[k - low];
+      offsets[k] = position[k - low];
+    }
+    for(size_t i=start[r]; i<start[r+1]; ++i) {
+      out[position[stagedKeys[i] - low]++] = std::move(staged[i]);
+    }
+  });
+  offsets[keys] = out.size();
+  return offsets;
+}
+
+} // namespace algo
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <type_traits>
+#include <vector>
+
+#include <Graph.hpp>
+#include <Parallel.hpp>
+
+namespace algo {
+
+// Edge seen by traversals over SoaGraph: target plus index into the edge columns
+struct EdgeRef
+{
+  int to;
+  size_t id;
+};
+
+// Structure of arrays graph. Topology is a CSR targets array, edge properties are separate
+// columns indexed by edge id (position in targets) and vertex properties columns indexed
+// by vertex. An algorithm allocates only the columns it uses, a BFS checking residual
+// capacity streams through targets and residuals, not through whole edge structs.
+// Edge ids of u are offsets[u] .. offsets[u+1], iterating edges(u) yields EdgeRef so
+// depthFirst / breadthFirst and their states work unchanged.
+template<bool DIRECTED=true>
+class SoaGraph
+{
+public:
+  using EdgeType=EdgeRef;
+  static constexpr bool Directed=DIRECTED;
+
+  template<typename T>
+  using Column=std::vector<T>;
+
+  class Iterator
+  {
+  public:
+    Iterator(const int* targets, size_t id): _targets(targets), _id(id) {}
+
+    EdgeRef operator*() const
+    {
+      return {_targets[_id], _id};
+    }
+
+    Iterator& operator++()
+    {
+      ++_id;
+      return *this;
+    }
+
+    bool operator!=(const Iterator& rhs) const
+    {
+      return _id != rhs._id;
+    }
+
+    bool operator==(const Iterator& rhs) const
+    {
+      return _id == rhs._id;
+    }
+
+  private:
+    const int* _targets;
+    size_t _id;
+  };
+
+  struct EdgeIds
+  {
+    const int* targets;
+    size_t first;
+    size_t last;
+
+    Iterator begin() const { return Iterator(targets, first); }
+    Iterator end() const { return Iterator(targets, last); }
+    size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+  };
+
+  SoaGraph(std::vector<size_t>&& offsets, std::vector<int>&& targets):
+    _offsets(std::move(offsets)), _targets(std::move(targets))
+  {}
+
+  // Topology of any graph providing vertices() and edges(u), edge ids follow its adjacency order
+  template<typename G>
+  explicit SoaGraph(const G& g, unsigned threads = hardwareThreads()): _offsets(g.vertices()+1, 0)
+  {
+    const size_t n = g.vertices();
+    for(size_t u=0; u<n; ++u) {
+      _offsets[u+1] = _offsets[u] + std::distance(g.edges(u).begin(), g.edges(u).end());
+    }
+    _targets.resize(_offsets[n]);
+    parallelFor(threads, n, [&](size_t begin, size_t end, unsigned) {
+      for(size_t u=begin; u<end; ++u) {
+        size_t id = _offsets[u];
+        for(const auto& e: g.edges(u)) {
+          _targets[id++] = e.to;
+        }
+      }
+    });
+  }
+
+  size_t vertices() const
+  {
+    return _offsets.size() - 1;
+  }
+
+  size_t edgeCount() const
+  {
+    return _targets.size();
+  }
+
+  EdgeIds edges(int u) const
+  {
+    return {_targets.data(), _offsets[u], _offsets[u+1]};
+  }
+
+  int target(size_t id) const
+  {
+    return _targets[id];
+  }
+
+  const std::vector<size_t>& offsets() const
+  {
+    return _offsets;
+  }
+
+  const std::vector<int>& targets() const
+  {
+    return _targets;
+  }
+
+  template<typename T>
+  Column<T> edgeColumn(const T& init = T()) const
+  {
+    return Column<T>(edgeCount(), init);
+  }
+
+  template<typename T>
+  Column<T> vertexColumn(const T& init = T()) const
+  {
+    return Column<T>(vertices(), init);
+  }
+
+  // Column filled with field(e) of the matching edges of g, g must be the graph this
+  // topology was built from
+  template<typename G, typename F>
+  auto edgeColumn(const G& g, F field, unsigned threads = hardwareThreads()) const
+  {
+    using T = std::decay_t<decltype(field(*g.edges(0).begin()))>;
+    Column<T> column(edgeCount());
+    parallelFor(threads, vertices(), [&](size_t begin, size_t end, unsigned) {
+      for(size_t u=begin; u<end; ++u) {
+        size_t id = _offsets[u];
+        for(const auto& e: g.edges(u)) {
+          column[id++] = field(e);
+        }
+      }
+    });
+    return column;
+  }
+
+private:
+  std::vector<size_t> _offsets;
+  std::vector<int> _targets;
+};
+
+} // namespace algo
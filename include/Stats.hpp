@@ -0,0 +1,121 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Opt-in instrumentation of the graph algorithms, configure with -DALGO_STATS=ON to enable.
+// Disabled, ALGO_COUNT and ALGO_PHASE expand to nothing, hot loops are the same code as
+// without them, algorithms keep an empty NoStats and the Stats returned alongside results
+// stay zero.
+#ifndef ALGO_STATS
+#define ALGO_STATS 0
+#endif
+
+#define ALGO_STATS_CONCAT_(a, b) a##b
+#define ALGO_STATS_CONCAT(a, b) ALGO_STATS_CONCAT_(a, b)
+
+#if ALGO_STATS
+#define ALGO_COUNT(counter, n) ((counter) += (n))
+#define ALGO_PHASE(stats, name) ::algo::PhaseTimer ALGO_STATS_CONCAT(phaseTimer, __LINE__)((stats), (name))
+#else
+#define ALGO_COUNT(counter, n) ((void)0)
+#define ALGO_PHASE(stats, name) ((void)0)
+#endif
+
+namespace algo {
+
+struct Stats
+{
+  static constexpr bool Enabled = ALGO_STATS;
+
+  struct Phase
+  {
+    std::string name;
+    double ms;
+  };
+
+  uint64_t edgeScans = 0;
+  uint64_t relaxations = 0;
+  uint64_t heapPushes = 0;
+  uint64_t heapPops = 0;
+  uint64_t decreaseKeys = 0;
+  uint64_t augmentingPaths = 0;
+  uint64_t pushes = 0;
+  uint64_t relabels = 0;
+  std::vector<Phase> phases;  // In order of first entry, repeated entries accumulate
+
+  void addPhase(const std::string& name, double ms)
+  {
+    for(auto& p: phases) {
+      if(p.name == name) {
+        p.ms += ms;
+        return;
+      }
+    }
+    phases.push_back({name, ms});
+  }
+
+  // Total time spent in phase name, 0 if never entered
+  double phase(const std::string& name) const
+  {
+    for(const auto& p: phases) {
+      if(p.name == name) {
+        return p.ms;
+      }
+    }
+    return 0;
+  }
+
+  Stats& operator+=(const Stats& rhs)
+  {
+    edgeScans += rhs.edgeScans;
+    relaxations += rhs.relaxations;
+    heapPushes += rhs.heapPushes;
+    heapPops += rhs.heapPops;
+    decreaseKeys += rhs.decreaseKeys;
+    augmentingPaths += rhs.augmentingPaths;
+    pushes += rhs.pushes;
+    relabels += rhs.relabels;
+    for(const auto& p: rhs.phases) {
+      addPhase(p.name, p.ms);
+    }
+    return *this;
+  }
+};
+
+// Placeholder kept by algorithms when statistics are compiled out
+struct NoStats
+{
+};
+
+// What algorithms collect into when the caller does not ask for statistics
+using ActiveStats = std::conditional<Stats::Enabled, Stats, NoStats>::type;
+
+template<typename T>
+struct WithStats
+{
+  T result;
+  Stats stats;
+};
+
+// Adds the wall time of its scope to a phase, use through ALGO_PHASE
+class PhaseTimer
+{
+public:
+  PhaseTimer(Stats& stats, const char* name): _stats(stats), _name(name), _start(std::chrono::steady_clock::now()) {}
+
+  ~PhaseTimer()
+  {
+    _stats.addPhase(_name, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _start).count());
+  }
+
+private:
+  Stats& _stats;
+  const char* _name;
+  std::chrono::steady_clock::time_point _start;
+};
+
+} // namespace algo
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+// Fixtures and reference algorithms shared by the tests of the graph representations
+namespace algo {
+namespace test {
+
+// File /tmp/algo_<pid>_<name>, removed when going out of scope
+class TempFile
+{
+public:
+  explicit TempFile(const std::string& name): _path("/tmp/algo_" + std::to_string(::getpid()) + "_" + name) {}
+
+  TempFile(const std::string& name, const std::string& content): TempFile(name)
+  {
+    write(content);
+  }
+
+  TempFile(const TempFile&) = delete;
+  TempFile& operator=(const TempFile&) = delete;
+
+  ~TempFile()
+  {
+    std::remove(_path.c_str());
+  }
+
+  const std::string& path() const
+  {
+    return _path;
+  }
+
+  void write(const std::string& content) const
+  {
+    std::ofstream(_path, std::ios::binary | std::ios::trunc) << content;
+  }
+
+  std::string read() const
+  {
+    std::ifstream in(_path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+
+private:
+  std::string _path;
+};
+
+// CLRS figure 26.1 as a DIMACS max flow problem, source 1, sink 6, max flow 23
+constexpr const char* DIMACS_MAX_FLOW =
+  "p max 6 9\nn 1 s\nn 6 t\na 1 2 16\na 1 3 13\na 2 4 12\na 3 2 4\na 3 5 14\na 4 3 9\na 4 6 20\na 5 4 7\na 5 6 4\n";
+
+// Weighted example graph of the METIS manual, 7 vertices and 11 edges, MST weight 12
+constexpr const char* METIS_EXAMPLE =
+  "7 11 001\n5 1 3 2 2 1\n1 1 3 2 4 1\n5 3 4 2 2 2 1 2\n2 1 3 2 6 2 7 5\n1 1 3 3 6 2\n5 2 4 2 7 6\n6 6 4 5\n";
+
+// Dijkstra on anything with vertices() and edges(u) of weighted edges, int max if unreachable
+template<typename G>
+std::vector<int> shortestPaths(const G& g, int source)
+{
+  std::vector<int> distance(g.vertices(), std::numeric_limits<int>::max());
+  using Item = std::pair<int, int>;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> heap;
+  distance[source] = 0;
+  heap.push({0, source});
+  while(!heap.empty()) {
+    const auto [d, u] = heap.top();
+    heap.pop();
+    if(d > distance[u]) {
+      continue;
+    }
+    for(const auto& e: g.edges(u)) {
+      if(d + e.weight < distance[e.to]) {
+        distance[e.to] = d + e.weight;
+        heap.push({distance[e.to], e.to});
+      }
+    }
+  }
+  return distance;
+}
+
+// Breadth first depth of every vertex from source, -1 if unreachable
+template<typename G>
+std::vector<int> bfsDepth(const G& g, int source)
+{
+  std::vector<int> depth(g.vertices(), -1);
+  std::queue<int> queue;
+  depth[source] = 0;
+  queue.push(source);
+  while(!queue.empty()) {
+    const int u = queue.front();
+    queue.pop();
+    for(const auto& e: g.edges(u)) {
+      if(depth[e.to] < 0) {
+        depth[e.to] = depth[u] + 1;
+        queue.push(e.to);
+      }
+    }
+  }
+  return depth;
+}
+
+} // namespace test
+} // namespace algo
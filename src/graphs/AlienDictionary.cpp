@@ -1,126 +1,207 @@
 #include <gtest/gtest.h>
 #include <iostream>
+#include <sstream>
 
 #include <algorithm>
-#include <cmath>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
-#include <stack>
 
-using Rule = std::pair<char, char>; // Denoting first smaller than second
+namespace algo {
+namespace alien {
 
-Rule getRule(const std::string& s1, const std::string& s2)
+std::u32string decodeUtf8(const std::string& s)
 {
-  int size = std::min(s1.size(), s2.size());
-  for(int i=0; i<size; ++i) {
-    if(s1[i] != s2[i]) {
-      return Rule(s1[i], s2[i]);
+  std::u32string result;
+  result.reserve(s.size());
+  for(size_t i=0; i<s.size(); ) {
+    const unsigned char c = s[i];
+    int length = 0;
+    char32_t cp = 0;
+    if(c < 0x80) {
+      length = 1;
+      cp = c;
+    } else if((c >> 5) == 0x6) {
+      length = 2;
+      cp = c & 0x1F;
+    } else if((c >> 4) == 0xE) {
+      length = 3;
+      cp = c & 0x0F;
+    } else if((c >> 3) == 0x1E) {
+      length = 4;
+      cp = c & 0x07;
+    } else {
+      throw std::runtime_error("Invalid UTF-8 sequence");
     }
+    if(i + length > s.size()) {
+      throw std::runtime_error("Truncated UTF-8 sequence");
+    }
+    for(int k=1; k<length; ++k) {
+      const unsigned char cc = s[i+k];
+      if((cc >> 6) != 0x2) {
+        throw std::runtime_error("Invalid UTF-8 sequence");
+      }
+      cp = (cp << 6) | (cc & 0x3F);
+    }
+    result.push_back(cp);
+    i += length;
   }
-  return Rule(0,0);
+  return result;
 }
 
-struct Node 
+std::string encodeUtf8(const std::u32string& s)
 {
-  Node(int s, char c): value(c), next(s, false) {}
-
-  bool isRoot = true;
-  char value;
-  std::vector<bool> next;
-};
+  std::string result;
+  result.reserve(s.size());
+  for(char32_t cp: s) {
+    if(cp < 0x80) {
+      result.push_back(static_cast<char>(cp));
+    } else if(cp < 0x800) {
+      result.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+      result.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if(cp < 0x10000) {
+      result.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+      result.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+      result.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+      result.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+      result.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+      result.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+      result.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+  }
+  return result;
+}
 
-struct Graph
+// Letter order of an alien language derived from its sorted word list. Words are consumed
+// one at a time, only the previous word is kept. Every adjacent pair gives at most one
+// precedence rule, letters are then ordered by Kahn's algorithm. Ties go to the smallest
+// code point through a heap, O(k log k + rules).
+class Dictionary
 {
-  Graph(int s): size(s)
+public:
+  // Registers letter even if it never takes part in any rule
+  int letter(char32_t c)
+  {
+    auto it = _index.find(c);
+    if(it != _index.end()) {
+      return it->second;
+    }
+    const int idx = _letters.size();
+    _index.emplace(c, idx);
+    _letters.push_back(c);
+    _next.emplace_back();
+    _inDegree.push_back(0);
+    return idx;
+  }
+
+  void add(const std::u32string& word)
   {
-    nodes.reserve(size);
-    for(int i=0; i<size; ++i) {
-      nodes.emplace_back(Node(size, 'a' + i));
+    for(char32_t c: word) {
+      letter(c);
+    }
+    const size_t size = std::min(_previous.size(), word.size());
+    size_t i = 0;
+    while(i < size && _previous[i] == word[i]) {
+      ++i;
     }
+    if(i < size) {
+      addRule(_previous[i], word[i]);
+    } else if(_previous.size() > word.size()) {
+      throw std::runtime_error("Word list is not sorted: prefix follows longer word");
+    }
+    _previous = word;
   }
 
-  int nidx(char c) const
+  void add(const std::string& utf8)
   {
-    return c-'a';
+    add(decodeUtf8(utf8));
   }
 
-  void addRule(const Rule& r)
+  // Whitespace separated UTF-8 words
+  void read(std::istream& strm)
   {
-    nodes[nidx(r.first)].next[nidx(r.second)] = true;
-    nodes[nidx(r.second)].isRoot = false;
+    std::string word;
+    while(strm >> word) {
+      add(word);
+    }
   }
 
-  std::string order()
+  // Letters with no remaining predecessors are emitted smallest code point first
+  std::u32string order() const
   {
-    std::string result;;
-    std::vector<int> topo(size, -1);
-    std::vector<bool> visited(size, false);
-    std::stack<int> stack;
-
-    for(auto& node: nodes) {
-      result.push_back(node.value);
-      if(node.isRoot) {
-        // std::cout << "Node " << node.value << " is a root" <<  std::endl;
-        int level = 0;
-        stack.push(nidx(node.value));
-        while(!stack.empty()) {
-          int idx = stack.top();
-          stack.pop();
-          ++level;
-
-          Node& n = nodes[idx];
-          if(topo[idx] < level) {
-            topo[idx] = level;
-          } else {
-            // std::cout << "Skipping node " << n.value << " on level " << level << std::endl;
-            continue;
-          }
-
-          // std::cout << "Visiting node " << n.value << " on level " << level << std::endl;
-          
-          bool hasNext = false;
-          for(int i=0; i<size; ++i) {
-            if(n.next[i]) {
-              stack.push(i);
-              hasNext = true;
-            }
-          }
-          if(!hasNext) {
-            // std::cout << "Node " << n.value << " is a leaf" <<  std::endl;
-            --level;
-          } 
+    std::vector<int> inDegree = _inDegree;
+    auto comp = [this](int a, int b) { return _letters[a] > _letters[b]; };
+    std::priority_queue<int, std::vector<int>, decltype(comp)> ready(comp);
+    for(size_t u=0; u<_letters.size(); ++u) {
+      if(inDegree[u] == 0) {
+        ready.push(static_cast<int>(u));
+      }
+    }
+
+    std::u32string result;
+    result.reserve(_letters.size());
+    while(!ready.empty()) {
+      const int u = ready.top();
+      ready.pop();
+      result.push_back(_letters[u]);
+      for(int v: _next[u]) {
+        if(--inDegree[v] == 0) {
+          ready.push(v);
         }
       }
     }
-    // std::cout << "Result before sorting " << result << std::endl;
-    std::sort(result.begin(), result.end(), [this, &topo](char c1, char c2) {
-      return topo[nidx(c1)] < topo[nidx(c2)];
-    });
-    // std::cout << "Result after sorting " << result << std::endl;
+    if(result.size() != _letters.size()) {
+      throw std::runtime_error("Inconsistent word list: letter precedence has a cycle");
+    }
     return result;
   }
 
-  const int size;
-  std::vector<Node> nodes;
+  size_t rules() const
+  {
+    return _rules.size();
+  }
+
+private:
+  void addRule(char32_t first, char32_t second)
+  {
+    const int u = _index[first];
+    const int v = _index[second];
+    const unsigned long long key = (static_cast<unsigned long long>(u) << 32) | static_cast<unsigned>(v);
+    if(_rules.insert(key).second) {
+      _next[u].push_back(v);
+      ++_inDegree[v];
+    }
+  }
+
+  std::u32string _previous;
+  std::unordered_map<char32_t, int> _index;
+  std::vector<char32_t> _letters;
+  std::vector<std::vector<int>> _next;
+  std::vector<int> _inDegree;
+  std::unordered_set<unsigned long long> _rules;
 };
 
+// Order of first k letters of latin alphabet
 std::string printOrder(std::string dict[], int N, int k)
 {
-  Graph g(k);
-  for(int i=1; i<N; ++i) {
-    Rule r = getRule(dict[i-1], dict[i]);
-    if(r.first != 0) {
-      // std::cout << "Found rule " << r.first << " < " << r.second << std::endl;
-      g.addRule(r);
-    }
+  Dictionary d;
+  for(int i=0; i<k; ++i) {
+    d.letter('a' + i);
   }
-
-  return g.order();
+  for(int i=0; i<N; ++i) {
+    d.add(dict[i]);
+  }
+  return encodeUtf8(d.order());
 }
 
-TEST(AlienDictionary, test1) 
+TEST(AlienDictionary, test1)
 {
   // Input:  Dict[] = { "baa", "abcd", "abca", "cab", "cad" }, k = 4
-  // Output: Function returns "bdac" 
+  // Output: Function returns "bdac"
 
   std::string dict[] = { "baa", "abcd", "abca", "cab", "cad" };
   EXPECT_EQ(printOrder(dict, 5, 4), "bdac");
@@ -133,16 +214,49 @@ TEST(AlienDictionary, test1)
 
 // 20 12
 // aagkllkackabaicaaackhehjcfjaieh aifheecdiaifgigad baciifif bdddbkacejgckajjfced beh bgajaheailelicfgbcffifdilgaealjk bgccbbcbjibl ccghfleijliglaidjjdkhaklhad ckbjfaeidhlbkiagi ckgifb daclag fcbkeeebclifafhbhiabdkbcejcbdifdhjhkeiaicgllhacdka fhfgikadkkgegbigkhahhdakhgckdahij fkbabfikfckkkdaeegehjhgelbkalaebfjlcdflbafkgeicbl hcggjbdjdlhekdbbibdfhhdggdgjkakgegjaeflaea hgkeacjgeclbjgjcg hhcgicdggbjhdbfgchhlcckfcdjdacckb hlkjjliihfilhc icheefbhcbhdajkacflfcfcgcfjijekkaffjh jcgigcbbbfklkajfdfajjiigace
-TEST(AlienDictionary, test2) 
+TEST(AlienDictionary, test2)
 {
-  std::string dict[] = {"aagkllkackabaicaaackhehjcfjaieh", "aifheecdiaifgigad", "baciifif", 
-    "bdddbkacejgckajjfced", "beh", "bgajaheailelicfgbcffifdilgaealjk", "bgccbbcbjibl", 
-    "ccghfleijliglaidjjdkhaklhad", "ckbjfaeidhlbkiagi", "ckgifb", "daclag", 
+  std::string dict[] = {"aagkllkackabaicaaackhehjcfjaieh", "aifheecdiaifgigad", "baciifif",
+    "bdddbkacejgckajjfced", "beh", "bgajaheailelicfgbcffifdilgaealjk", "bgccbbcbjibl",
+    "ccghfleijliglaidjjdkhaklhad", "ckbjfaeidhlbkiagi", "ckgifb", "daclag",
     "fcbkeeebclifafhbhiabdkbcejcbdifdhjhkeiaicgllhacdka", "fhfgikadkkgegbigkhahhdakhgckdahij",
     "fkbabfikfckkkdaeegehjhgelbkalaebfjlcdflbafkgeicbl", "hcggjbdjdlhekdbbibdfhhdggdgjkakgegjaeflaea",
-    "hgkeacjgeclbjgjcg", "hhcgicdggbjhdbfgchhlcckfcdjdacckb", "hlkjjliihfilhc", 
+    "hgkeacjgeclbjgjcg", "hhcgicdggbjhdbfgchhlcckfcdjdacckb", "hlkjjliihfilhc",
     "icheefbhcbhdajkacflfcfcgcfjijekkaffjh", "jcgigcbbbfklkajfdfajjiigace"};
 
-  
-  printOrder(dict, 20, 12);
-}
\ No newline at end of file
+  const std::string order = printOrder(dict, 20, 12);
+  ASSERT_EQ(order.size(), 12);
+  for(int i=1; i<20; ++i) {
+    const std::string& s1 = dict[i-1];
+    const std::string& s2 = dict[i];
+    auto m = std::mismatch(s1.begin(), s1.end(), s2.begin(), s2.end());
+    if(m.first != s1.end() && m.second != s2.end()) {
+      EXPECT_LT(order.find(*m.first), order.find(*m.second));
+    }
+  }
+}
+
+TEST(AlienDictionary, unicode)
+{
+  std::istringstream words(u8"ωα ωβ αβγ αγ γ");
+  Dictionary d;
+  d.read(words);
+  EXPECT_EQ(encodeUtf8(d.order()), u8"ωαβγ");
+  EXPECT_EQ(d.rules(), 4);
+}
+
+TEST(AlienDictionary, inconsistent)
+{
+  Dictionary cycle;
+  cycle.add("ab");
+  cycle.add("ba");
+  cycle.add("aa");
+  EXPECT_THROW(cycle.order(), std::runtime_error);
+
+  Dictionary prefix;
+  prefix.add("abc");
+  EXPECT_THROW(prefix.add("ab"), std::runtime_error);
+}
+
+} // namespace alien
+} // namespace algo
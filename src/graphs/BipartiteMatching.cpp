@@ -1,7 +1,14 @@
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <set>
+
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
 #include <Graph.hpp>
+#include <Parallel.hpp>
 
 namespace algo {
 namespace bipartite {
@@ -81,7 +88,238 @@ struct BipartiteGraph: public GenericGraph<>
     adjacency[l].push_back({v});
   }
 
+  // Hopcroft-Karp on the left to right adjacency: layered BFS from free left vertices,
+  // then vertex disjoint shortest augmenting paths found by DFS, O(E sqrt(V)).
   Matching maximumMatching()
+  {
+    int phases = 0;
+    return maximumMatching(phases);
+  }
+
+  // Same, phases is set to the number of BFS + DFS rounds, at most 2 sqrt(V) + 1
+  Matching maximumMatching(int& phases)
+  {
+    const int half = size/2;
+    const int INF = std::numeric_limits<int>::max();
+    VerticeList matchL(half, -1);
+    VerticeList matchR(half, -1);
+    VerticeList dist(half);
+    std::vector<size_t> current(half);
+    VerticeList stack;
+
+    // Greedy initial matching
+    for(int u=0; u<half; ++u) {
+      for(const auto& e: adjacency[u]) {
+        const int v = e.to - half;
+        if(matchR[v] < 0) {
+          matchL[u] = v;
+          matchR[v] = u;
+          break;
+        }
+      }
+    }
+
+    // Layer of the left vertices next to the nearest free right vertices, layers beyond
+    // it are not built so that only shortest augmenting paths are followed
+    int limit = INF;
+    auto bfs = [&]() {
+      std::queue<int> queue;
+      for(int u=0; u<half; ++u) {
+        if(matchL[u] < 0) {
+          dist[u] = 0;
+          queue.push(u);
+        } else {
+          dist[u] = INF;
+        }
+      }
+      limit = INF;
+      while(!queue.empty()) {
+        const int u = queue.front();
+        queue.pop();
+        if(dist[u] > limit) {
+          break;
+        }
+        for(const auto& e: adjacency[u]) {
+          const int w = matchR[e.to - half];
+          if(w < 0) {
+            limit = dist[u];
+          } else if(dist[w] == INF) {
+            dist[w] = dist[u] + 1;
+            queue.push(w);
+          }
+        }
+      }
+      return limit != INF;
+    };
+
+    // Iterative DFS along the layers, dead ends are removed from the layered graph
+    auto augment = [&](int root) {
+      stack.assign(1, root);
+      while(!stack.empty()) {
+        const int u = stack.back();
+        if(current[u] == adjacency[u].size()) {
+          dist[u] = INF;
+          stack.pop_back();
+          continue;
+        }
+        const int v = adjacency[u][current[u]++].to - half;
+        const int w = matchR[v];
+        if(w < 0 && dist[u] == limit) {
+          for(int x: stack) {
+            const int y = adjacency[x][current[x]-1].to - half;
+            matchL[x] = y;
+            matchR[y] = x;
+          }
+          return true;
+        } else if(w >= 0 && dist[u] < limit && dist[w] == dist[u] + 1) {
+          stack.push_back(w);
+        }
+      }
+      return false;
+    };
+
+    phases = 0;
+    while(bfs()) {
+      ++phases;
+      std::fill(current.begin(), current.end(), 0);
+      for(int u=0; u<half; ++u) {
+        if(matchL[u] < 0) {
+          augment(u);
+        }
+      }
+    }
+
+    Matching result;
+    for(int u=0; u<half; ++u) {
+      if(matchL[u] >= 0) {
+        result.emplace_back(u, matchL[u]);
+      }
+    }
+    return result;
+  }
+
+  // Multi-threaded Pothen-Fan (PF+): in every phase threads run DFS searches from free
+  // left vertices, right vertices are claimed with an atomic flag, so augmenting paths
+  // found in one phase are vertex disjoint. Lookahead pointers persist between phases,
+  // scan direction alternates. Stops after a phase without any augmentation.
+  Matching parallelMaximumMatching(unsigned threads = hardwareThreads())
+  {
+    const int half = size/2;
+    VerticeList matchL(half, -1);
+    std::vector<std::atomic<int>> matchR(half);
+    std::vector<std::atomic<char>> visited(half);
+    VerticeList lookahead(half, 0);
+    VerticeList current(half);
+
+    for(int v=0; v<half; ++v) {
+      matchR[v].store(-1, std::memory_order_relaxed);
+    }
+
+    auto claim = [&](int v) {
+      char expected = 0;
+      return visited[v].compare_exchange_strong(expected, 1, std::memory_order_acq_rel);
+    };
+
+    // Greedy initial matching
+    parallelFor(threads, half, [&](size_t begin, size_t end, unsigned) {
+      for(size_t u=begin; u<end; ++u) {
+        for(const auto& e: adjacency[u]) {
+          int expected = -1;
+          if(matchR[e.to - half].compare_exchange_strong(expected, u, std::memory_order_acq_rel)) {
+            matchL[u] = e.to - half;
+            break;
+          }
+        }
+      }
+    });
+
+    VerticeList roots;
+    std::atomic<size_t> next(0);
+    std::atomic<bool> augmented(true);
+    bool forward = true;
+
+    auto search = [&](int root, VerticeList& stack) {
+      stack.assign(1, root);
+      while(!stack.empty()) {
+        const int u = stack.back();
+        const auto& edges = adjacency[u];
+        const int degree = edges.size();
+
+        // Lookahead for a free right vertice
+        int found = -1;
+        while(found < 0 && lookahead[u] < degree) {
+          const int v = edges[lookahead[u]++].to - half;
+          if(matchR[v].load(std::memory_order_relaxed) < 0 && claim(v)) {
+            found = v;
+          }
+        }
+
+        if(found < 0) {
+          int w = -1;
+          while(w < 0 && current[u] < degree) {
+            const int k = current[u]++;
+            const int v = edges[forward ? k : degree-1-k].to - half;
+            if(claim(v)) {
+              w = matchR[v].load(std::memory_order_relaxed);
+            }
+          }
+          if(w < 0) {
+            stack.pop_back();
+          } else {
+            current[w] = 0;
+            stack.push_back(w);
+          }
+          continue;
+        }
+
+        // Flip the path: every left vertice on the stack takes the right vertice it was reached from
+        for(int i=stack.size()-1; i>=0; --i) {
+          const int x = stack[i];
+          const int previous = matchL[x];
+          matchL[x] = found;
+          matchR[found].store(x, std::memory_order_relaxed);
+          found = previous;
+        }
+        return true;
+      }
+      return false;
+    };
+
+    while(augmented) {
+      augmented = false;
+      roots.clear();
+      for(int u=0; u<half; ++u) {
+        if(matchL[u] < 0) {
+          roots.push_back(u);
+        }
+      }
+      for(auto& v: visited) {
+        v.store(0, std::memory_order_relaxed);
+      }
+      next = 0;
+      parallelRun(threads, [&](unsigned) {
+        VerticeList stack;
+        for(size_t i=next++; i<roots.size(); i=next++) {
+          current[roots[i]] = 0;
+          if(search(roots[i], stack)) {
+            augmented.store(true, std::memory_order_relaxed);
+          }
+        }
+      });
+      forward = !forward;
+    }
+
+    Matching result;
+    for(int u=0; u<half; ++u) {
+      if(matchL[u] >= 0) {
+        result.emplace_back(u, matchL[u]);
+      }
+    }
+    return result;
+  }
+
+  // Reference implementation by max flow in a unit capacity network
+  Matching maximumMatchingFlow()
   {
     ResidualFlowGraph rg(size+2);
     int source = size;
@@ -137,6 +375,90 @@ struct BipartiteGraph: public GenericGraph<>
 
 using Match=BipartiteGraph::Match;
 
+// Matching maintained while left vertices arrive one by one. Each arrival searches a single
+// augmenting path starting at the new vertice, any augmenting path of the extended graph has
+// to start there, so the matching stays maximum.
+class OnlineMatching
+{
+public:
+  using Matching=BipartiteGraph::Matching;
+
+  OnlineMatching(size_t right): _matchR(right, -1), _visited(right, 0) {}
+
+  // Adds left vertice with given right neighbours, returns right vertice it got matched to or -1
+  int add(const std::vector<int>& neighbours)
+  {
+    const int root = _adjacency.size();
+    _adjacency.push_back(neighbours);
+    _matchL.push_back(-1);
+    _current.push_back(0);
+    ++_stamp;
+
+    _stack.assign(1, root);
+    _current[root] = 0;
+    while(!_stack.empty()) {
+      const int u = _stack.back();
+      if(_current[u] == _adjacency[u].size()) {
+        _stack.pop_back();
+        continue;
+      }
+      const int v = _adjacency[u][_current[u]++];
+      if(_visited[v] == _stamp) {
+        continue;
+      }
+      _visited[v] = _stamp;
+      const int w = _matchR[v];
+      if(w >= 0) {
+        _current[w] = 0;
+        _stack.push_back(w);
+        continue;
+      }
+      int free = v;
+      for(int i=_stack.size()-1; i>=0; --i) {
+        const int x = _stack[i];
+        const int previous = _matchL[x];
+        _matchL[x] = free;
+        _matchR[free] = x;
+        free = previous;
+      }
+      ++_size;
+      break;
+    }
+    return _matchL[root];
+  }
+
+  int match(int left) const
+  {
+    return _matchL.at(left);
+  }
+
+  size_t size() const
+  {
+    return _size;
+  }
+
+  Matching matching() const
+  {
+    Matching result;
+    for(size_t u=0; u<_matchL.size(); ++u) {
+      if(_matchL[u] >= 0) {
+        result.emplace_back(u, _matchL[u]);
+      }
+    }
+    return result;
+  }
+
+private:
+  std::vector<std::vector<int>> _adjacency;
+  std::vector<int> _matchL;
+  std::vector<int> _matchR;
+  std::vector<size_t> _current;
+  std::vector<int> _stack;
+  std::vector<int> _visited; // stamp of the last search which visited right vertice
+  int _stamp = 0;
+  size_t _size = 0;
+};
+
 TEST(BipartiteMatching, test1)
 {
   BipartiteGraph g(6);
@@ -167,6 +489,128 @@ TEST(BipartiteMatching, test2)
 
   auto match = g.maximumMatching();
   EXPECT_THAT(match, testing::ElementsAre(Match(0,0), Match(1,2), Match(2,1)));
+  EXPECT_THAT(g.maximumMatchingFlow(), testing::ElementsAre(Match(0,0), Match(1,2), Match(2,1)));
+}
+
+BipartiteGraph randomBipartite(int n, int edges, unsigned seed)
+{
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> node(0, n-1);
+  BipartiteGraph g(n);
+  for(int i=0; i<edges; ++i) {
+    g.connect(node(gen), node(gen));
+  }
+  return g;
+}
+
+bool isMatching(const BipartiteGraph::Matching& m)
+{
+  std::set<int> left, right;
+  for(const auto& [l, r]: m) {
+    if(!left.insert(l).second || !right.insert(r).second) {
+      return false;
+    }
+  }
+  return true;
+}
+
+TEST(BipartiteMatching, random)
+{
+  for(unsigned seed=1; seed<=10; ++seed) {
+    BipartiteGraph g = randomBipartite(30, 50, seed);
+    auto match = g.maximumMatching();
+    EXPECT_TRUE(isMatching(match));
+    EXPECT_THAT(match.size(), testing::Eq(g.maximumMatchingFlow().size()));
+  }
+}
+
+TEST(BipartiteMatching, shortestPaths)
+{
+  // Greedy leaves 4 and 5 free with disjoint augmenting paths of length 3. Following
+  // the first edges, 4 -> 2 -> 3 -> 0 -> 0 -> 3 is an augmenting path of length 5 which
+  // takes the free right vertex 3 of 5's only path. Accepting it costs a second phase.
+  const std::vector<std::vector<int>> adj = {{0, 3}, {5, 4, 3, 0}, {4, 2, 5, 3}, {0, 2, 1}, {2}, {5}};
+  BipartiteGraph g(adj.size());
+  for(size_t l=0; l<adj.size(); ++l) {
+    for(int r: adj[l]) {
+      g.connect(l, r);
+    }
+  }
+  int phases = 0;
+  EXPECT_THAT(g.maximumMatching(phases).size(), testing::Eq(6));
+  EXPECT_THAT(phases, testing::Eq(1));
+
+  for(unsigned seed=1; seed<=3; ++seed) {
+    const int n = 1000;
+    BipartiteGraph h = randomBipartite(n, 2*n, seed);
+    auto match = h.maximumMatching(phases);
+    EXPECT_TRUE(isMatching(match));
+    EXPECT_THAT(match.size(), testing::Eq(h.maximumMatchingFlow().size()));
+    EXPECT_THAT(phases, testing::Le(2*std::sqrt(2.0*n) + 1));
+  }
+}
+
+TEST(BipartiteMatching, online)
+{
+  OnlineMatching m(3);
+  EXPECT_THAT(m.add({0, 1}), testing::Eq(0));
+  // Vertice 1 takes 0 over by moving vertice 0 to 1
+  EXPECT_THAT(m.add({0}), testing::Eq(0));
+  EXPECT_THAT(m.match(0), testing::Eq(1));
+  EXPECT_THAT(m.add({1}), testing::Eq(-1));
+  EXPECT_THAT(m.add({0, 2}), testing::Eq(2));
+  EXPECT_THAT(m.size(), testing::Eq(3));
+  EXPECT_TRUE(isMatching(m.matching()));
+}
+
+TEST(BipartiteMatching, onlineRandom)
+{
+  std::mt19937 gen(3);
+  const int n = 40;
+  std::uniform_int_distribution<int> node(0, n-1);
+  std::uniform_int_distribution<int> degree(0, 3);
+
+  BipartiteGraph g(n);
+  OnlineMatching m(n);
+  for(int u=0; u<n; ++u) {
+    std::vector<int> neighbours;
+    for(int d=degree(gen); d>0; --d) {
+      neighbours.push_back(node(gen));
+      g.connect(u, neighbours.back());
+    }
+    m.add(neighbours);
+  }
+  EXPECT_TRUE(isMatching(m.matching()));
+  EXPECT_THAT(m.size(), testing::Eq(g.maximumMatching().size()));
+}
+
+TEST(BipartiteMatching, parallel)
+{
+  for(unsigned seed=1; seed<=10; ++seed) {
+    BipartiteGraph g = randomBipartite(200, 400, seed);
+    const size_t expected = g.maximumMatching().size();
+    for(unsigned threads: {1, 2, 4}) {
+      auto match = g.parallelMaximumMatching(threads);
+      EXPECT_TRUE(isMatching(match));
+      EXPECT_THAT(match.size(), testing::Eq(expected));
+    }
+  }
+}
+
+TEST(BipartiteMatching, DISABLED_benchmark)
+{
+  BipartiteGraph g = randomBipartite(250000, 1000000, 42);
+  auto start = std::chrono::steady_clock::now();
+  auto match = g.maximumMatching();
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  std::cout << "Hopcroft-Karp: " << match.size() << " matches in " << elapsed.count() << " ms" << std::endl;
+
+  for(unsigned threads=1; threads<=hardwareThreads(); threads*=2) {
+    start = std::chrono::steady_clock::now();
+    match = g.parallelMaximumMatching(threads);
+    elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "Pothen-Fan, " << threads << " threads: " << match.size() << " matches in " << elapsed.count() << " ms" << std::endl;
+  }
 }
 
 } // namespace bipartite
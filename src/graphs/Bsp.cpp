@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <Bsp.hpp>
+#include <GraphGenerator.hpp>
+
+namespace algo {
+namespace bsp {
+namespace {
+
+using Graph = GenericGraph<WeightedEdge>;
+
+std::vector<int> shortestPaths(const Graph& g, int source, bool unit)
+{
+  std::vector<int> distance(g.vertices(), UNREACHED);
+  distance[source] = 0;
+  for(size_t i=1; i<g.vertices(); ++i) {
+    for(size_t u=0; u<g.vertices(); ++u) {
+      if(distance[u] == UNREACHED) {
+        continue;
+      }
+      for(const auto& e: g.edges(u)) {
+        distance[e.to] = std::min(distance[e.to], distance[u] + (unit ? 1 : e.weight));
+      }
+    }
+  }
+  return distance;
+}
+
+} // namespace
+
+TEST(Bsp, channel)
+{
+  // Two local processes swapping messages larger than the socket buffers
+  Channel channel(2);
+  const pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  const int me = pid == 0 ? 1 : 0;
+  channel.attach(me);
+  std::vector<std::vector<int>> out(2, std::vector<int>(1 << 20, me));
+  bool ok = true;
+  try {
+    auto in = channel.exchange(out);
+    ok = in[1-me].size() == (1u << 20) && in[1-me][12345] == 1-me && channel.allReduce(me + 1) == 3;
+  } catch(const std::exception&) {
+    ok = false;
+  }
+  if(pid == 0) {
+    _exit(ok ? 0 : 1);
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  EXPECT_TRUE(ok);
+  EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+TEST(Bsp, bfs)
+{
+  Graph g = generate::rmat(9, 8, 4, 10).graph<Graph>();
+  const auto expected = shortestPaths(g, 0, true);
+  for(int k: {1, 2, 4}) {
+    auto r1 = bfs(partition::oneD(g, k), 0);
+    EXPECT_EQ(r1.values, expected);
+    EXPECT_FALSE(r1.negativeCycle);
+    auto r2 = bfs(partition::twoD(g, k), 0);
+    EXPECT_EQ(r2.values, expected);
+    EXPECT_EQ(r2.supersteps, r1.supersteps);
+  }
+}
+
+TEST(Bsp, bellmanFord)
+{
+  Graph g = generate::grid(15, 20, 5, 30).graph<Graph>();
+  const auto expected = shortestPaths(g, 7, false);
+  for(int k: {3, 4}) {
+    EXPECT_EQ(bellmanFord(partition::oneD(g, k), 7).values, expected);
+    EXPECT_EQ(bellmanFord(partition::twoD(g, k), 7).values, expected);
+  }
+
+  Graph cycle(4);
+  cycle.connect(0, 1, 1);
+  cycle.connect(1, 2, -3);
+  cycle.connect(2, 1, 1);
+  cycle.connect(2, 3, 1);
+  EXPECT_TRUE(bellmanFord(partition::oneD(cycle, 2), 0).negativeCycle);
+  EXPECT_TRUE(bellmanFord(partition::twoD(cycle, 4), 0).negativeCycle);
+}
+
+} // namespace bsp
+} // namespace algo
@@ -0,0 +1,117 @@
+#include <chrono>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <CompressedGraph.hpp>
+#include <GraphGenerator.hpp>
+#include <GraphReorder.hpp>
+#include <TestFiles.hpp>
+
+namespace algo {
+namespace {
+
+using Graph = GenericGraph<>;
+
+// What vector<vector<GenericEdge>> holds: vector headers plus 4 bytes per edge
+size_t adjacencyMemory(const Graph& g)
+{
+  size_t bytes = g.vertices()*sizeof(std::vector<GenericEdge>);
+  for(size_t u=0; u<g.vertices(); ++u) {
+    bytes += g.edges(u).size()*sizeof(GenericEdge);
+  }
+  return bytes;
+}
+
+} // namespace
+
+TEST(CompressedGraph, varint)
+{
+  for(int64_t v: {0LL, 1LL, -1LL, 127LL, 128LL, -300LL, 1LL << 40, -(1LL << 40)}) {
+    std::vector<uint8_t> buffer;
+    varint::put(buffer, varint::zigzag(v));
+    const uint8_t* p = buffer.data();
+    EXPECT_EQ(varint::unzigzag(varint::get(p)), v);
+    EXPECT_EQ(p, buffer.data() + buffer.size());
+  }
+}
+
+TEST(CompressedGraph, neighbours)
+{
+  Graph g = generate::rmat(10, 8, 1).graph<Graph>();
+  for(unsigned threads: {1u, 3u}) {
+    CompressedGraph cg(g, threads);
+    ASSERT_EQ(cg.vertices(), g.vertices());
+    EXPECT_EQ(cg.edgeCount(), 1024*8);
+    for(size_t u=0; u<g.vertices(); ++u) {
+      std::vector<int> expected, actual;
+      for(const auto& e: g.edges(u)) {
+        expected.push_back(e.to);
+      }
+      for(const auto& e: cg.edges(u)) {
+        actual.push_back(e.to);
+      }
+      std::sort(expected.begin(), expected.end());
+      ASSERT_EQ(actual, expected);
+      ASSERT_EQ(cg.edges(u).size(), expected.size());
+    }
+  }
+}
+
+TEST(CompressedGraph, traversal)
+{
+  Graph g = generate::erdosRenyi(2000, 8000, 2).graph<Graph>();
+  CompressedGraph cg(g);
+  EXPECT_EQ(test::bfsDepth(cg, 0), test::bfsDepth(g, 0));
+
+  CompressedGraph t = cg.transposed();
+  std::vector<int> in(2000, 0), out(2000, 0);
+  for(int u=0; u<2000; ++u) {
+    in[u] = t.edges(u).size();
+    for(const auto& e: g.edges(u)) {
+      ++out[e.to];
+    }
+  }
+  EXPECT_EQ(in, out);
+}
+
+TEST(CompressedGraph, memory)
+{
+  Graph grid = generate::grid(300, 300, 1).graph<Graph>();
+  Graph g = reorder::relabel(grid, reorder::reverseCuthillMcKee(grid));
+  CompressedGraph cg(g);
+  EXPECT_LT(cg.memory()*3, adjacencyMemory(g));
+}
+
+TEST(CompressedGraph, DISABLED_benchmark)
+{
+  Graph raw = generate::rmat(18, 16, 1).graph<Graph>();
+  Graph g = reorder::relabel(raw, reorder::gorder(raw));
+  CompressedGraph cg(g);
+  auto csr = generate::rmat(18, 16, 1).csr();
+  std::cout << "vector<vector>: " << adjacencyMemory(g)/1e6 << "MB, csr: "
+            << (csr.edgeCount()*sizeof(GenericEdge) + csr.offsets().size()*sizeof(size_t))/1e6 << "MB, compressed: "
+            << cg.memory()/1e6 << "MB" << std::endl;
+
+  auto time = [](const auto& graph) {
+    std::vector<int> depth(graph.vertices(), -1);
+    std::vector<int> queue(graph.vertices());
+    auto start = std::chrono::steady_clock::now();
+    size_t head = 0, tail = 0;
+    depth[0] = 0;
+    queue[tail++] = 0;
+    while(head < tail) {
+      const int u = queue[head++];
+      for(const auto& e: graph.edges(u)) {
+        if(depth[e.to] < 0) {
+          depth[e.to] = depth[u] + 1;
+          queue[tail++] = e.to;
+        }
+      }
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  };
+  std::cout << "bfs vector<vector>: " << time(g) << "ms, compressed: " << time(cg) << "ms" << std::endl;
+}
+
+} // namespace algo
@@ -0,0 +1,100 @@
+#include <chrono>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <CsrGraph.hpp>
+#include <GraphGenerator.hpp>
+
+namespace algo {
+namespace {
+
+using Graph = GenericGraph<WeightedEdge>;
+
+// (source, target, weight) of every edge, sorted
+template<typename G>
+std::vector<std::tuple<int, int, int>> edgeList(const G& g, bool reversed = false)
+{
+  std::vector<std::tuple<int, int, int>> result;
+  for(size_t u=0; u<g.vertices(); ++u) {
+    for(const auto& e: g.edges(u)) {
+      if(reversed) {
+        result.emplace_back(e.to, u, e.weight);
+      } else {
+        result.emplace_back(u, e.to, e.weight);
+      }
+    }
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+} // namespace
+
+TEST(CsrGraph, countingSort)
+{
+  // Keys of [0, n) shuffled, stability keeps equal keys in production order
+  const size_t n = 10000;
+  for(unsigned threads: {1u, 2u, 7u}) {
+    std::vector<size_t> out;
+    auto offsets = countingSort(n, 100, [](size_t begin, size_t end, auto&& emit) {
+      for(size_t i=begin; i<end; ++i) {
+        emit((i*37) % 100, i);
+      }
+    }, out, threads);
+    ASSERT_EQ(offsets.size(), 101);
+    ASSERT_EQ(out.size(), n);
+    for(size_t k=0; k<100; ++k) {
+      ASSERT_EQ(offsets[k+1] - offsets[k], 100);
+      for(size_t i=offsets[k]; i<offsets[k+1]; ++i) {
+        EXPECT_EQ((out[i]*37) % 100, k);
+        if(i > offsets[k]) {
+          EXPECT_LT(out[i-1], out[i]);
+        }
+      }
+    }
+  }
+}
+
+TEST(CsrGraph, transpose)
+{
+  Graph g = generate::rmat(10, 8, 3, 100).graph<Graph>();
+  const auto expected = edgeList(g, true);
+
+  auto csr = toCsr(g, 3);
+  EXPECT_EQ(edgeList(csr), edgeList(g));
+
+  for(unsigned threads: {1u, 4u}) {
+    auto t = transposeCsr(g, threads);
+    EXPECT_EQ(edgeList(t), expected);
+    for(size_t v=0; v<t.vertices(); ++v) {
+      EXPECT_TRUE(std::is_sorted(t.edges(v).begin(), t.edges(v).end(), [](const auto& a, const auto& b) { return a.to < b.to; }));
+    }
+    const auto single = transposeCsr(g, 1);
+    EXPECT_EQ(t.offsets(), single.offsets());
+    EXPECT_TRUE(std::equal(t.edgeArray().begin(), t.edgeArray().end(), single.edgeArray().begin(), [](const auto& a, const auto& b) {
+      return a.to == b.to && a.weight == b.weight;
+    }));
+
+    // Weights used to be dropped by the in-place transpose
+    Graph gt(g);
+    gt.transpose(threads);
+    EXPECT_EQ(edgeList(gt), expected);
+    gt.transpose(threads);
+    EXPECT_EQ(edgeList(gt), edgeList(g));
+  }
+}
+
+TEST(CsrGraph, DISABLED_benchmark)
+{
+  auto g = generate::rmat(22, 16, 1, 100).csr<WeightedEdge>();
+  for(unsigned threads: {1u, hardwareThreads()}) {
+    auto start = std::chrono::steady_clock::now();
+    auto t = transposeCsr(g, threads);
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << threads << " threads: transpose of " << g.edgeCount() << " edges " << ms << "ms, "
+              << g.edgeCount()*sizeof(WeightedEdge)/ms/1e6 << "GB/s" << std::endl;
+  }
+}
+
+} // namespace algo
@@ -4,6 +4,11 @@
 #include <gmock/gmock.h>
 
 #include <Graph.hpp>
+#include <GraphGenerator.hpp>
+#include <GraphReader.hpp>
+#include <GraphReorder.hpp>
+#include <Stats.hpp>
+#include <TestFiles.hpp>
 
 namespace algo {
 namespace dijkstra {
@@ -13,6 +18,23 @@ struct Graph: GenericGraph<WeightedEdge>
   Graph(size_t s): GenericGraph(s) {}
 
   VerticeList dijkstra(int source)
+  {
+    ActiveStats stats;
+    return dijkstra(source, stats);
+  }
+
+  WithStats<VerticeList> dijkstraWithStats(int source)
+  {
+    WithStats<VerticeList> r;
+    {
+      ALGO_PHASE(r.stats, "dijkstra");
+      r.result = dijkstra(source, r.stats);
+    }
+    return r;
+  }
+
+  template<typename S>
+  VerticeList dijkstra(int source, S& stats)
   {
     Flags known(size, false);             // Vertices already taken by greedy approach
     Flags onHeap(size, false);            // Helper flag indicating is vertice is already on heap
@@ -29,6 +51,7 @@ struct Graph: GenericGraph<WeightedEdge>
     std::vector<int> heap; 
     heap.push_back(source);
     onHeap[source] = true;
+    ALGO_COUNT(stats.heapPushes, 1);
 
     while(!heap.empty()) {
       // Pop item from heap
@@ -36,6 +59,7 @@ struct Graph: GenericGraph<WeightedEdge>
       std::pop_heap(heap.begin(), heap.end(), comp);
       heap.pop_back();
       onHeap[u] = false;
+      ALGO_COUNT(stats.heapPops, 1);
 
       // Mark vertice as visited
       known[u] = true;
@@ -46,6 +70,7 @@ struct Graph: GenericGraph<WeightedEdge>
       // Loop over adjacency list
       for(const auto& edge: adjacency[u]) {
         const int v = edge.to;
+        ALGO_COUNT(stats.edgeScans, 1);
         // If the vertice was not yet visited
         if(!known[v]) {
           // New potential distance to v
@@ -53,15 +78,18 @@ struct Graph: GenericGraph<WeightedEdge>
           if(aux < distance[v]) { 
             // Shorter path found
             distance[v] = aux;
+            ALGO_COUNT(stats.relaxations, 1);
 
             if(onHeap[v]) { 
               // Distance updated need to rebuild heap
               rebuildHeap = true;
+              ALGO_COUNT(stats.decreaseKeys, 1);
             } else {
               // Push new vertice on heap
               heap.push_back(v);
               std::push_heap(heap.begin(), heap.end(), comp);
               onHeap[v] = true;
+              ALGO_COUNT(stats.heapPushes, 1);
             }
           }
         }
@@ -122,5 +150,48 @@ TEST(Dijkstra, test1)
   EXPECT_EQ(distance[5], 7);
 }
 
+TEST(Dijkstra, dimacs)
+{
+  const test::TempFile file("dijkstra.gr", "c same graph as test1\np sp 6 7\na 1 2 3\na 1 6 7\na 2 3 4\na 2 5 2\na 4 5 6\na 6 3 3\na 6 5 1\n");
+  auto g = readDimacs<Graph>(file.path(), 2).graph;
+  EXPECT_THAT(g.dijkstra2(0), testing::ElementsAre(0, 3, 7, std::numeric_limits<int>::max(), 5, 7));
+}
+
+TEST(Dijkstra, reordered)
+{
+  Graph g = generate::rmat(9, 8, 3, 50).graph<Graph>();
+  const auto expected = g.dijkstra(0);
+  for(const auto& p: {reorder::reverseCuthillMcKee(g), reorder::gorder(g)}) {
+    Graph r = reorder::relabel(g, p);
+    EXPECT_EQ(reorder::restore(r.dijkstra(p[0]), p), expected);
+  }
+}
+
+TEST(Dijkstra, stats)
+{
+  Graph g = generate::rmat(9, 8, 3, 50).graph<Graph>();
+  const auto r = g.dijkstraWithStats(0);
+  EXPECT_EQ(r.result, g.dijkstra(0));
+  if(Stats::Enabled) {
+    size_t reached = 0, scanned = 0;
+    for(size_t u=0; u<g.vertices(); ++u) {
+      if(r.result[u] != std::numeric_limits<int>::max()) {
+        ++reached;
+        scanned += g.edges(u).size();
+      }
+    }
+    EXPECT_EQ(r.stats.heapPushes, reached);
+    EXPECT_EQ(r.stats.heapPops, reached);
+    EXPECT_EQ(r.stats.edgeScans, scanned);
+    EXPECT_GE(r.stats.relaxations, reached - 1);
+    EXPECT_LE(r.stats.decreaseKeys, r.stats.relaxations);
+    EXPECT_EQ(r.stats.phases.size(), 1);
+    EXPECT_GT(r.stats.phase("dijkstra"), 0);
+  } else {
+    EXPECT_EQ(r.stats.edgeScans + r.stats.relaxations + r.stats.heapPushes + r.stats.heapPops, 0);
+    EXPECT_TRUE(r.stats.phases.empty());
+  }
+}
+
 } // namespace dijkstra
 } // namespace algo
\ No newline at end of file
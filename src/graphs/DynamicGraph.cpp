@@ -0,0 +1,174 @@
+#include <limits>
+#include <random>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <DynamicGraph.hpp>
+#include <TestFiles.hpp>
+
+namespace algo {
+namespace {
+
+using Graph = DynamicGraph<WeightedEdge>;
+using Model = std::vector<std::vector<std::pair<int, int>>>;
+
+Model dump(const Graph::Snapshot& s)
+{
+  Model result(s.vertices());
+  for(size_t u=0; u<s.vertices(); ++u) {
+    for(const auto& e: s.edges(u)) {
+      result[u].emplace_back(e.to, e.weight);
+    }
+    std::sort(result[u].begin(), result[u].end());
+  }
+  return result;
+}
+
+} // namespace
+
+TEST(DynamicGraph, updates)
+{
+  Graph g(4);
+  Graph::Batch b1;
+  b1.insert(0, 1, 5);
+  b1.insert(1, 2, 1);
+  b1.insert(0, 2, 10);
+  auto s1 = g.apply(b1);
+  EXPECT_THAT(test::shortestPaths(*s1, 0), testing::ElementsAre(0, 5, 6, std::numeric_limits<int>::max()));
+
+  Graph::Batch b2;
+  b2.remove(1, 2);
+  b2.insert(2, 3, 2);
+  b2.insert(5, 3, 1);
+  auto s2 = g.apply(b2);
+  EXPECT_EQ(s2->vertices(), 6);
+  EXPECT_EQ(s2->edgeCount(), 4);
+  EXPECT_THAT(test::shortestPaths(*s2, 0), testing::ElementsAre(0, 5, 10, 12, std::numeric_limits<int>::max(), std::numeric_limits<int>::max()));
+
+  // Published versions never change
+  EXPECT_EQ(s1->version(), 1);
+  EXPECT_EQ(s1->vertices(), 4);
+  EXPECT_THAT(test::shortestPaths(*s1, 0), testing::ElementsAre(0, 5, 6, std::numeric_limits<int>::max()));
+  EXPECT_EQ(g.snapshot(), s2);
+}
+
+TEST(DynamicGraph, sharedDeltas)
+{
+  Graph g(3);
+  Graph::Batch b1;
+  b1.insert(0, 1, 1);
+  b1.insert(1, 2, 1);
+  auto s1 = g.apply(b1);
+
+  // Only the delta of vertex 1 is copied, vertex 0 keeps the one of version 1
+  Graph::Batch b2;
+  b2.insert(1, 0, 2);
+  auto s2 = g.apply(b2);
+  EXPECT_EQ(&*s1->edges(0).begin(), &*s2->edges(0).begin());
+  EXPECT_NE(&*s1->edges(1).begin(), &*s2->edges(1).begin());
+  EXPECT_EQ(dump(*s1), Model({{{1, 1}}, {{2, 1}}, {}}));
+  EXPECT_EQ(dump(*s2), Model({{{1, 1}}, {{0, 2}, {2, 1}}, {}}));
+}
+
+TEST(DynamicGraph, vertexIds)
+{
+  Graph g(4);
+  Graph::Batch bad;
+  bad.insert(0, 1, 1);
+  bad.remove(5, 3);
+  EXPECT_THROW(g.apply(bad), std::out_of_range);
+  Graph::Batch negative;
+  negative.insert(-1, 1, 1);
+  EXPECT_THROW(g.apply(negative), std::out_of_range);
+  // Failed batches publish nothing
+  EXPECT_EQ(g.snapshot()->version(), 0);
+  EXPECT_EQ(g.snapshot()->edgeCount(), 0);
+
+  // Removals do not add vertices, inserts do, a large id adds levels to the delta tree
+  Graph::Batch b;
+  b.remove(3, 0);
+  b.insert(70000, 3, 2);
+  b.insert(3, 70000, 1);
+  b.insert(40, 3, 4);
+  auto s = g.apply(b);
+  EXPECT_EQ(s->vertices(), 70001);
+  EXPECT_EQ(test::shortestPaths(*s, 40)[70000], 5);
+  EXPECT_EQ(test::shortestPaths(*s, 70000)[3], 2);
+}
+
+TEST(DynamicGraph, random)
+{
+  // Enough updates to go through several compactions
+  std::mt19937 gen(3);
+  std::uniform_int_distribution<int> node(0, 99);
+  std::uniform_int_distribution<int> weight(1, 9);
+  Graph g(100, 2);
+  Model model(100);
+  for(int round=0; round<40; ++round) {
+    Graph::Batch batch;
+    for(int i=0; i<200; ++i) {
+      const int u = node(gen);
+      const int v = node(gen);
+      if(i % 3 == 0) {
+        batch.remove(u, v);
+        auto& list = model[u];
+        list.erase(std::remove_if(list.begin(), list.end(), [v](const auto& e) { return e.first == v; }), list.end());
+      } else {
+        const int w = weight(gen);
+        batch.insert(u, v, w);
+        model[u].emplace_back(v, w);
+      }
+    }
+    auto s = g.apply(batch);
+    for(auto& list: model) {
+      std::sort(list.begin(), list.end());
+    }
+    ASSERT_EQ(dump(*s), model);
+    size_t edges = 0;
+    for(const auto& list: model) {
+      edges += list.size();
+    }
+    EXPECT_EQ(s->edgeCount(), edges);
+  }
+}
+
+TEST(DynamicGraph, concurrentReaders)
+{
+  // Batch k appends edge k -> k+1, a snapshot of version v reaches exactly v+1 vertices
+  const int n = 300;
+  Graph g(n);
+  std::atomic<bool> done(false);
+  std::atomic<int> checks(0);
+  std::vector<std::thread> readers;
+  for(int r=0; r<3; ++r) {
+    // At least one check each, the writer may be done before a reader gets scheduled
+    readers.emplace_back([&] {
+      do {
+        auto s = g.snapshot();
+        GenericGraph<WeightedEdge>::TraversalState state(s->vertices());
+        breadthFirst(*s, 0, state);
+        const size_t reached = std::count(state.discovered.begin(), state.discovered.end(), true);
+        EXPECT_EQ(reached, s->version() + 1);
+        ++checks;
+      } while(!done.load());
+    });
+  }
+  for(int k=0; k+1<n; ++k) {
+    Graph::Batch batch;
+    batch.insert(k, k+1, 1);
+    // Noise that does not change reachability from 0
+    batch.insert(k+1, 0, 1);
+    batch.remove(k+1, 0);
+    g.apply(batch);
+  }
+  done = true;
+  for(auto& t: readers) {
+    t.join();
+  }
+  EXPECT_GT(checks.load(), 0);
+  EXPECT_EQ(test::shortestPaths(*g.snapshot(), 0)[n-1], n-1);
+}
+
+} // namespace algo
@@ -1,20 +1,29 @@
+#include <chrono>
 #include <queue> 
+#include <random>
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
 #include <Graph.hpp>
+#include <GraphGenerator.hpp>
+#include <GraphReader.hpp>
+#include <SoaGraph.hpp>
+#include <Stats.hpp>
+#include <TestFiles.hpp>
 
 namespace algo {
 namespace edmonds {
 
 struct ResidualEdge
 {
-  ResidualEdge(int t, int r): to(t), residual(r) {}
+  ResidualEdge(int t, int r, int rev = -1, bool o = true): to(t), residual(r), reverse(rev), original(o) {}
 
   int to;
   int residual;
   int flow = 0;
+  int reverse;   // Index of the reverse edge in adjacency[to]
+  bool original; // False for edges added only to carry residual capacity
 };
 
 struct CapacityEdge
@@ -30,24 +39,31 @@ struct ResidualFlowGraph: public GenericGraph<ResidualEdge>
   {
     for(int u=0; u<size; ++u) {
       for(const auto& e: adj[u]) {
-        connect(u, e.to, e.capacity);
-        connect(e.to, u, 0);
+        const int ru = adjacency[e.to].size() + (u == e.to ? 1 : 0);
+        const int rv = adjacency[u].size();
+        connect(u, e.to, e.capacity, ru, true);
+        connect(e.to, u, 0, rv, false);
       }
     }    
   }
 
-  int volume(const VerticeList& path) const
+  // Edge u -> v with the largest residual, there may be several due to parallel and reverse edges
+  ResidualEdge& edge(int u, int v)
+  {
+    ResidualEdge* result = nullptr;
+    for(ResidualEdge& e: adjacency[u]) {
+      if(e.to == v && (!result || e.residual > result->residual)) {
+        result = &e;
+      }
+    }
+    return *result;
+  }
+
+  int volume(const VerticeList& path)
   {
     int result = std::numeric_limits<int>::max();
     for(int i=0; i<path.size()-1;++i) {
-      int u = path[i];
-      int v = path[i+1];
-      for(const ResidualEdge& e: adjacency[u]) {
-        if(e.to == v) {
-          result = std::min(result, e.residual);
-          break;
-        }
-      }
+      result = std::min(result, edge(path[i], path[i+1]).residual);
     }
     return result;
   }
@@ -55,26 +71,94 @@ struct ResidualFlowGraph: public GenericGraph<ResidualEdge>
   void augment(const VerticeList& path, int vol)
   {
     for(int i=0; i<path.size()-1;++i) {
-      int u = path[i];
-      int v = path[i+1];
-      for(ResidualEdge& e: adjacency[u]) {
-        if(e.to == v) {
-          e.flow += vol;
-          e.residual -= vol;
-          break;
-        }
+      ResidualEdge& e = edge(path[i], path[i+1]);
+      ResidualEdge& r = adjacency[e.to][e.reverse];
+      e.flow += vol;
+      e.residual -= vol;
+      r.residual += vol;
+      r.flow -= vol;
+    }
+  }
+
+  int flow(int source) const
+  {
+    int f = 0;
+    for(const ResidualEdge& e: adjacency[source]) {
+      f += e.flow;
+    }
+    return f;
+  }
+};
+
+// Flow kept between calls, so that after capacity changes the maximum flow is repaired
+// instead of recomputed. Lowering capacity below the current flow first tries to reroute
+// the surplus around the edge and cancels only what cannot be rerouted.
+struct IncrementalFlow: public GenericGraph<ResidualEdge>
+{
+  template<typename EL>
+  IncrementalFlow(const EL& adj, int s, int t): GenericGraph(adj.size()), source(s), sink(t), parent(size)
+  {
+    for(int u=0; u<static_cast<int>(size); ++u) {
+      for(const auto& e: adj[u]) {
+        const int ru = adjacency[e.to].size() + (u == e.to ? 1 : 0);
+        const int rv = adjacency[u].size();
+        connect(u, e.to, e.capacity, ru, true);
+        connect(e.to, u, 0, rv, false);
       }
-      for(ResidualEdge& e: adjacency[v]) {
-        if(e.to == u) {
-          e.residual += vol;
-          e.flow -= vol;
-          break;
-        }
+    }
+  }
+
+  int maxFlow()
+  {
+    augment(source, sink, std::numeric_limits<int>::max());
+    return flow();
+  }
+
+  void setCapacity(int u, int v, int capacity)
+  {
+    ResidualEdge& e = edge(u, v);
+    ResidualEdge& r = adjacency[v][e.reverse];
+    if(capacity >= e.flow) {
+      e.residual = capacity - e.flow;
+      return;
+    }
+
+    // Surplus left at u and missing at v
+    int surplus = e.flow - capacity;
+    e.flow = capacity;
+    e.residual = 0;
+    r.flow = -capacity;
+    r.residual = capacity;
+
+    surplus -= augment(u, v, surplus);
+    if(surplus > 0) {
+      // Send the rest back towards the source and pull it from the sink
+      if(u != source) {
+        augment(u, source, surplus);
+      }
+      if(v != sink) {
+        augment(sink, v, surplus);
       }
     }
   }
 
-  int flow(int source) const
+  void addCapacity(int u, int v, int delta)
+  {
+    setCapacity(u, v, capacity(u, v) + delta);
+  }
+
+  int capacity(int u, int v)
+  {
+    const ResidualEdge& e = edge(u, v);
+    return e.residual + e.flow;
+  }
+
+  int flow(int u, int v)
+  {
+    return edge(u, v).flow;
+  }
+
+  int flow() const
   {
     int f = 0;
     for(const ResidualEdge& e: adjacency[source]) {
@@ -82,40 +166,247 @@ struct ResidualFlowGraph: public GenericGraph<ResidualEdge>
     }
     return f;
   }
+
+  const int source;
+  const int sink;
+
+private:
+  ResidualEdge& edge(int u, int v)
+  {
+    for(ResidualEdge& e: adjacency[u]) {
+      if(e.to == v && e.original) {
+        return e;
+      }
+    }
+    throw std::runtime_error("Edge not found");
+  }
+
+  // Pushes up to limit units along shortest residual paths from s to t
+  int augment(int s, int t, int limit)
+  {
+    int pushed = 0;
+    while(pushed < limit && bfs(s, t)) {
+      int volume = limit - pushed;
+      for(int v=t; v!=s; ) {
+        const auto& [u, i] = parent[v];
+        volume = std::min(volume, adjacency[u][i].residual);
+        v = u;
+      }
+      for(int v=t; v!=s; ) {
+        const auto& [u, i] = parent[v];
+        ResidualEdge& e = adjacency[u][i];
+        ResidualEdge& r = adjacency[v][e.reverse];
+        e.flow += volume;
+        e.residual -= volume;
+        r.flow -= volume;
+        r.residual += volume;
+        v = u;
+      }
+      pushed += volume;
+    }
+    return pushed;
+  }
+
+  bool bfs(int s, int t)
+  {
+    Flags discovered(size, false);
+    std::queue<int> queue;
+    queue.push(s);
+    discovered[s] = true;
+    while(!queue.empty()) {
+      const int u = queue.front();
+      queue.pop();
+      const int degree = adjacency[u].size();
+      for(int i=0; i<degree; ++i) {
+        const ResidualEdge& e = adjacency[u][i];
+        if(!discovered[e.to] && e.residual > 0) {
+          discovered[e.to] = true;
+          parent[e.to] = {u, i};
+          if(e.to == t) {
+            return true;
+          }
+          queue.push(e.to);
+        }
+      }
+    }
+    return false;
+  }
+
+  std::vector<std::pair<int, int>> parent; // Parent vertice and index of the edge used
+};
+
+// Residual network stored as columns: the BFS reads only targets and residuals, the
+// reverse column is touched only along augmenting paths. Flow is capacity - residual.
+struct ColumnarFlowGraph
+{
+  template<typename EL>
+  ColumnarFlowGraph(const EL& adj): topology(build(adj))
+  {
+    capacity = topology.edgeColumn<int>(0);
+    reverse = topology.edgeColumn<size_t>(0);
+    std::vector<size_t> pos(topology.offsets().begin(), topology.offsets().end()-1);
+    for(size_t u=0; u<adj.size(); ++u) {
+      for(const auto& e: adj[u]) {
+        const size_t forward = pos[u]++;
+        const size_t backward = pos[e.to]++;
+        capacity[forward] = e.capacity;
+        reverse[forward] = backward;
+        reverse[backward] = forward;
+      }
+    }
+    residual = capacity;
+    parentEdge = topology.vertexColumn<size_t>(0);
+  }
+
+  template<typename EL>
+  static SoaGraph<> build(const EL& adj)
+  {
+    std::vector<size_t> offsets(adj.size()+1, 0);
+    for(size_t u=0; u<adj.size(); ++u) {
+      for(const auto& e: adj[u]) {
+        ++offsets[u+1];
+        ++offsets[e.to+1];
+      }
+    }
+    for(size_t u=0; u<adj.size(); ++u) {
+      offsets[u+1] += offsets[u];
+    }
+    std::vector<int> targets(offsets.back());
+    std::vector<size_t> pos(offsets.begin(), offsets.end()-1);
+    for(size_t u=0; u<adj.size(); ++u) {
+      for(const auto& e: adj[u]) {
+        targets[pos[u]++] = e.to;
+        targets[pos[e.to]++] = u;
+      }
+    }
+    return SoaGraph<>(std::move(offsets), std::move(targets));
+  }
+
+  bool bfs(int s, int t)
+  {
+    std::vector<bool> discovered(topology.vertices(), false);
+    std::queue<int> queue;
+    queue.push(s);
+    discovered[s] = true;
+    while(!queue.empty()) {
+      const int u = queue.front();
+      queue.pop();
+      for(const auto e: topology.edges(u)) {
+        if(!discovered[e.to] && residual[e.id] > 0) {
+          discovered[e.to] = true;
+          parentEdge[e.to] = e.id;
+          if(e.to == t) {
+            return true;
+          }
+          queue.push(e.to);
+        }
+      }
+    }
+    return false;
+  }
+
+  int maxFlow(int s, int t)
+  {
+    while(bfs(s, t)) {
+      int volume = std::numeric_limits<int>::max();
+      for(int v=t; v!=s; v=topology.target(reverse[parentEdge[v]])) {
+        volume = std::min(volume, residual[parentEdge[v]]);
+      }
+      for(int v=t; v!=s; v=topology.target(reverse[parentEdge[v]])) {
+        residual[parentEdge[v]] -= volume;
+        residual[reverse[parentEdge[v]]] += volume;
+      }
+    }
+    int f = 0;
+    for(const auto e: topology.edges(s)) {
+      f += capacity[e.id] - residual[e.id];
+    }
+    return f;
+  }
+
+  SoaGraph<> topology;
+  SoaGraph<>::Column<int> capacity;
+  SoaGraph<>::Column<int> residual;
+  SoaGraph<>::Column<size_t> reverse;
+  SoaGraph<>::Column<size_t> parentEdge;
 };
 
 struct Graph: public GenericGraph<CapacityEdge>
 {
   Graph(size_t s): GenericGraph(s) {}
 
+  IncrementalFlow incrementalFlow(int source, int sink) const
+  {
+    return IncrementalFlow(adjacency, source, sink);
+  }
+
   int maxFlow(int source, int sink)
   {
-    ResidualFlowGraph rg(adjacency);
+    ActiveStats stats;
+    return maxFlow(source, sink, stats);
+  }
+
+  // Phases: build (residual network), bfs, augment
+  WithStats<int> maxFlowWithStats(int source, int sink)
+  {
+    WithStats<int> r;
+    r.result = maxFlow(source, sink, r.stats);
+    return r;
+  }
+
+  template<typename S>
+  int maxFlow(int source, int sink, S& stats)
+  {
+    ResidualFlowGraph rg = [&]() {
+      ALGO_PHASE(stats, "build");
+      return ResidualFlowGraph(adjacency);
+    }();
 
     struct State: public ResidualFlowGraph::TraversalState
     {
-      State(size_t s): ResidualFlowGraph::TraversalState(s) {}
+      State(size_t s, S& stats): ResidualFlowGraph::TraversalState(s), stats(stats) {}
+
+#if ALGO_STATS
+      void processEdge(int v, const ResidualEdge& e) override
+      {
+        ALGO_COUNT(stats.edgeScans, 1);
+      }
+#endif
 
       bool validEdge(const ResidualEdge& e)
       {
         return e.residual > 0;
       }
-    };
 
-    State state(size);
-    rg.bfsImpl(source, state);
-    VerticeList augmentingPath = rg.buildPath(source, sink, state.parent);
+      S& stats;
+    };
 
-    while(!augmentingPath.empty()) {
-      int augmentingVolume = rg.volume(augmentingPath);
-      rg.augment(augmentingPath, augmentingVolume);
+    State state(size, stats);
+    auto search = [&]() {
+      ALGO_PHASE(stats, "bfs");
       state.reset();
       rg.bfsImpl(source, state);
-      augmentingPath = rg.buildPath(source, sink, state.parent);
+      return rg.buildPath(source, sink, state.parent);
+    };
+    VerticeList augmentingPath = search();
+
+    while(!augmentingPath.empty()) {
+      {
+        ALGO_PHASE(stats, "augment");
+        int augmentingVolume = rg.volume(augmentingPath);
+        rg.augment(augmentingPath, augmentingVolume);
+        ALGO_COUNT(stats.augmentingPaths, 1);
+      }
+      augmentingPath = search();
     }
 
     return rg.flow(source);
   }
+
+  int columnarMaxFlow(int source, int sink) const
+  {
+    return ColumnarFlowGraph(adjacency).maxFlow(source, sink);
+  }
 };
 
 TEST(EdmondsKarp, test1)
@@ -134,5 +425,138 @@ TEST(EdmondsKarp, test1)
   EXPECT_THAT(g.maxFlow(0,5), testing::Eq(23));
 }
 
+TEST(EdmondsKarp, stats)
+{
+  Graph g(6);
+  g.connect(0,1,16);
+  g.connect(0,2,13);
+  g.connect(1,3,12);
+  g.connect(2,1,4);
+  g.connect(2,4,14);
+  g.connect(3,2,9);
+  g.connect(3,5,20);
+  g.connect(4,3,7);
+  g.connect(4,5,4);
+
+  auto r = g.maxFlowWithStats(0,5);
+  EXPECT_EQ(r.result, 23);
+  if(Stats::Enabled) {
+    EXPECT_GE(r.stats.augmentingPaths, 3);
+    EXPECT_GT(r.stats.edgeScans, 0);
+    EXPECT_EQ(r.stats.phases.size(), 3);
+  } else {
+    EXPECT_EQ(r.stats.augmentingPaths, 0);
+    EXPECT_TRUE(r.stats.phases.empty());
+  }
+}
+
+TEST(EdmondsKarp, columnar)
+{
+  Graph g(6);
+  g.connect(0,1,16);
+  g.connect(0,2,13);
+  g.connect(1,3,12);
+  g.connect(2,1,4);
+  g.connect(2,4,14);
+  g.connect(3,2,9);
+  g.connect(3,5,20);
+  g.connect(4,3,7);
+  g.connect(4,5,4);
+  EXPECT_EQ(g.columnarMaxFlow(0,5), 23);
+
+  for(unsigned seed=1; seed<=5; ++seed) {
+    Graph r = generate::layeredFlow(4, 5, 3, 20, seed).graph<Graph>();
+    EXPECT_EQ(r.columnarMaxFlow(0, r.vertices()-1), r.maxFlow(0, r.vertices()-1));
+  }
+}
+
+TEST(EdmondsKarp, DISABLED_benchmark)
+{
+  Graph g = generate::layeredFlow(20, 100, 6, 100, 7).graph<Graph>();
+  const int sink = g.vertices()-1;
+  auto time = [](auto&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    const int flow = fn();
+    return std::make_pair(flow, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+  };
+  const auto aos = time([&] { return g.maxFlow(0, sink); });
+  const auto soa = time([&] { return g.columnarMaxFlow(0, sink); });
+  EXPECT_EQ(aos.first, soa.first);
+  std::cout << "interleaved edges: " << aos.second << "ms, edge columns: " << soa.second << "ms" << std::endl;
+}
+
+TEST(EdmondsKarp, dimacs)
+{
+  const test::TempFile file("edmonds.max", test::DIMACS_MAX_FLOW);
+  auto dimacs = readDimacs<Graph>(file.path(), 3);
+  EXPECT_EQ(dimacs.source, 0);
+  EXPECT_EQ(dimacs.sink, 5);
+  EXPECT_EQ(dimacs.graph.maxFlow(dimacs.source, dimacs.sink), 23);
+}
+
+TEST(EdmondsKarp, incremental)
+{
+  Graph g(6);
+  g.connect(0,1,16);
+  g.connect(0,2,13);
+  g.connect(1,3,12);
+  g.connect(2,1,4);
+  g.connect(2,4,14);
+  g.connect(3,2,9);
+  g.connect(3,5,20);
+  g.connect(4,3,7);
+  g.connect(4,5,4);
+
+  IncrementalFlow f = g.incrementalFlow(0,5);
+  EXPECT_THAT(f.maxFlow(), testing::Eq(23));
+
+  f.setCapacity(3,5,10);
+  EXPECT_THAT(f.capacity(3,5), testing::Eq(10));
+  EXPECT_THAT(f.maxFlow(), testing::Eq(14));
+
+  f.addCapacity(3,5,10);
+  EXPECT_THAT(f.maxFlow(), testing::Eq(23));
+
+  f.setCapacity(0,1,0);
+  EXPECT_THAT(f.maxFlow(), testing::Eq(13));
+}
+
+TEST(EdmondsKarp, incrementalRandom)
+{
+  struct Edge { int u; int v; int capacity; };
+
+  std::mt19937 gen(11);
+  const int n = 10;
+  std::uniform_int_distribution<int> node(0, n-1);
+  std::uniform_int_distribution<int> capacity(0, 15);
+
+  std::vector<Edge> edges;
+  for(int i=0; i<30; ++i) {
+    edges.push_back({node(gen), node(gen), capacity(gen)});
+  }
+  auto build = [&]() {
+    Graph g(n);
+    for(const auto& e: edges) {
+      g.connect(e.u, e.v, e.capacity);
+    }
+    return g;
+  };
+
+  IncrementalFlow f = build().incrementalFlow(0, n-1);
+  for(int step=0; step<50; ++step) {
+    auto& e = edges[std::uniform_int_distribution<int>(0, edges.size()-1)(gen)];
+    // Only the first u -> v edge is addressed by (u, v)
+    const bool first = &e == &*std::find_if(edges.begin(), edges.end(), [&e](const Edge& x) {
+      return x.u == e.u && x.v == e.v;
+    });
+    if(!first) {
+      continue;
+    }
+    e.capacity = capacity(gen);
+    f.setCapacity(e.u, e.v, e.capacity);
+    ASSERT_THAT(f.maxFlow(), testing::Eq(build().maxFlow(0, n-1)));
+  }
+}
+
 } // edmonds
 } // namespace algo
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <random>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <GraphFile.hpp>
+#include <TestFiles.hpp>
+
+namespace algo {
+namespace {
+
+template<typename EDGE>
+GenericGraph<EDGE> randomGraph(int n, int m, unsigned seed)
+{
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> node(0, n-1);
+  std::uniform_int_distribution<int> weight(1, 100);
+  GenericGraph<EDGE> g(n);
+  for(int i=0; i<m; ++i) {
+    if constexpr(std::is_same<EDGE, WeightedEdge>::value) {
+      g.connect(node(gen), node(gen), weight(gen));
+    } else {
+      g.connect(node(gen), node(gen));
+    }
+  }
+  return g;
+}
+
+} // namespace
+
+TEST(GraphFile, roundTrip)
+{
+  const test::TempFile file("roundtrip.bin");
+  const std::string& path = file.path();
+  GenericGraph<WeightedEdge> g(6);
+  g.connect(0,1,3);
+  g.connect(0,5,7);
+  g.connect(1,2,4);
+  g.connect(1,4,2);
+  g.connect(3,4,6);
+  g.connect(5,2,3);
+  g.connect(5,4,1);
+  saveGraph(g, path);
+
+  MappedGraph<WeightedEdge> mg(path);
+  ASSERT_EQ(mg.vertices(), 6);
+  EXPECT_EQ(mg.edgeCount(), 7);
+  for(int u=0; u<6; ++u) {
+    ASSERT_EQ(mg.edges(u).size(), g.edges(u).size());
+    for(size_t i=0; i<g.edges(u).size(); ++i) {
+      EXPECT_EQ(mg.edges(u)[i].to, g.edges(u)[i].to);
+      EXPECT_EQ(mg.edges(u)[i].weight, g.edges(u)[i].weight);
+    }
+  }
+  EXPECT_THAT(test::shortestPaths(mg, 0), testing::ElementsAre(0, 3, 7, std::numeric_limits<int>::max(), 5, 7));
+}
+
+TEST(GraphFile, random)
+{
+  const test::TempFile file("random.bin");
+  const std::string& path = file.path();
+  auto g = randomGraph<GenericEdge>(1000, 5000, 3);
+  saveGraph(g, path);
+  MappedGraph<> mg(path);
+  EXPECT_EQ(test::bfsDepth(mg, 0), test::bfsDepth(g, 0));
+
+  auto wg = randomGraph<WeightedEdge>(1000, 5000, 4);
+  saveGraph(wg, path);
+  MappedGraph<WeightedEdge> wmg(path);
+  EXPECT_EQ(test::shortestPaths(wmg, 0), test::shortestPaths(wg, 0));
+}
+
+TEST(GraphFile, invalid)
+{
+  std::string path;
+  {
+    const test::TempFile file("invalid.bin");
+    path = file.path();
+    saveGraph(randomGraph<GenericEdge>(10, 20, 5), path);
+    EXPECT_THROW(MappedGraph<WeightedEdge> wrongType(path), std::runtime_error);
+  }
+  EXPECT_THROW(MappedGraph<> missing(path), std::runtime_error);
+}
+
+TEST(GraphFile, corrupted)
+{
+  const test::TempFile file("corrupted.bin");
+  saveGraph(randomGraph<GenericEdge>(10, 20, 6), file.path());
+  const std::string bytes = file.read();
+  auto open = [&file](const std::string& content) {
+    file.write(content);
+    return MappedGraph<>(file.path());
+  };
+  auto patch = [&bytes](size_t at, uint64_t value) {
+    std::string copy = bytes;
+    std::memcpy(&copy[at], &value, sizeof(value));
+    return copy;
+  };
+  const size_t vertices = offsetof(GraphFileHeader, vertices);
+  const size_t edges = offsetof(GraphFileHeader, edges);
+  const size_t offsets = sizeof(GraphFileHeader);
+  const size_t targets = offsets + 11*sizeof(uint64_t);
+
+  EXPECT_NO_THROW(open(bytes).validate());
+  EXPECT_THROW(open(bytes.substr(0, bytes.size() - 1)), std::runtime_error);
+  EXPECT_THROW(open(bytes.substr(0, 10)), std::runtime_error);
+  // Sizes wrapping around to the real file size
+  EXPECT_THROW(open(patch(edges, 20 + (uint64_t(1) << 62))), std::runtime_error);
+  EXPECT_THROW(open(patch(vertices, ~uint64_t(0))), std::runtime_error);
+  // Offsets not starting at 0 or not ending at the edge count
+  EXPECT_THROW(open(patch(offsets, 1)), std::runtime_error);
+  EXPECT_THROW(open(patch(offsets + 10*sizeof(uint64_t), 19)), std::runtime_error);
+  // Decreasing offsets and targets out of range are only found by validate()
+  MappedGraph<> decreasing = open(patch(offsets + 5*sizeof(uint64_t), 1000));
+  EXPECT_THROW(decreasing.validate(), std::runtime_error);
+  MappedGraph<> bad = open(patch(targets, 10));
+  EXPECT_THROW(bad.validate(), std::runtime_error);
+}
+
+TEST(GraphFile, DISABLED_benchmark)
+{
+  const test::TempFile file("benchmark.bin");
+  const std::string& path = file.path();
+  const int n = 1 << 22;
+  const int m = 1 << 25;
+  {
+    auto g = randomGraph<WeightedEdge>(n, m, 6);
+    saveGraph(g, path);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  MappedGraph<WeightedEdge> mg(path);
+  auto mapped = std::chrono::steady_clock::now();
+  long long total = 0;
+  for(int u=0; u<n; ++u) {
+    for(const auto& e: mg.edges(u)) {
+      total += e.weight;
+    }
+  }
+  auto scanned = std::chrono::steady_clock::now();
+  std::cout << "map: " << std::chrono::duration<double, std::milli>(mapped - start).count() << "ms"
+            << " first scan: " << std::chrono::duration<double, std::milli>(scanned - mapped).count() << "ms"
+            << " (" << total << ")" << std::endl;
+
+  start = std::chrono::steady_clock::now();
+  GenericGraph<WeightedEdge> g(n);
+  for(int u=0; u<n; ++u) {
+    for(const auto& e: mg.edges(u)) {
+      g.connect(u, e.to, e.weight);
+    }
+  }
+  std::cout << "connect(): " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << "ms" << std::endl;
+}
+
+} // namespace algo
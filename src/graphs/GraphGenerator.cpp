@@ -0,0 +1,170 @@
+#include <chrono>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <GraphGenerator.hpp>
+
+namespace algo {
+namespace generate {
+namespace {
+
+template<typename G>
+std::vector<std::pair<int, int>> flatten(const G& g)
+{
+  std::vector<std::pair<int, int>> result;
+  for(size_t u=0; u<g.vertices(); ++u) {
+    for(const auto& e: g.edges(u)) {
+      result.emplace_back(e.to, e.weight);
+    }
+    result.emplace_back(-1, -1);
+  }
+  return result;
+}
+
+} // namespace
+
+TEST(GraphGenerator, deterministic)
+{
+  auto single = rmat(10, 8, 5, 100, 0.57, 0.19, 0.19, 1).csr<WeightedEdge>(1);
+  auto multi = rmat(10, 8, 5, 100, 0.57, 0.19, 0.19, 4).csr<WeightedEdge>(3);
+  EXPECT_EQ(single.offsets(), multi.offsets());
+  EXPECT_EQ(flatten(single), flatten(multi));
+  EXPECT_NE(flatten(single), flatten(rmat(10, 8, 6, 100).csr<WeightedEdge>()));
+}
+
+TEST(GraphGenerator, rmat)
+{
+  auto g = rmat(12, 16, 1).csr();
+  ASSERT_EQ(g.vertices(), 4096);
+  EXPECT_EQ(g.edgeCount(), 4096*16);
+  size_t maxDegree = 0;
+  for(int u=0; u<4096; ++u) {
+    maxDegree = std::max(maxDegree, g.edges(u).size());
+    for(const auto& e: g.edges(u)) {
+      ASSERT_LT(e.to, 4096);
+    }
+  }
+  // Skewed degree distribution, the hub is far above average degree 16
+  EXPECT_GT(maxDegree, 160);
+}
+
+TEST(GraphGenerator, grid)
+{
+  auto g = grid(3, 4, 2, 9).graph<GenericGraph<WeightedEdge>>();
+  ASSERT_EQ(g.vertices(), 12);
+  size_t edges = 0;
+  for(int u=0; u<12; ++u) {
+    edges += g.edges(u).size();
+    for(const auto& e: g.edges(u)) {
+      EXPECT_EQ(std::abs(e.to/4 - u/4) + std::abs(e.to%4 - u%4), 1);
+      EXPECT_THAT(e.weight, testing::AllOf(testing::Ge(1), testing::Le(9)));
+    }
+  }
+  EXPECT_EQ(edges, 2*(3*3 + 2*4));
+  EXPECT_EQ(g.edges(0).size(), 2);
+  EXPECT_EQ(g.edges(5).size(), 4);
+}
+
+TEST(GraphGenerator, randomDag)
+{
+  auto g = randomDag(500, 4000, 3).csr();
+  std::vector<int> inDegree(500, 0);
+  for(int u=0; u<500; ++u) {
+    for(const auto& e: g.edges(u)) {
+      ++inDegree[e.to];
+    }
+  }
+  std::vector<int> ready;
+  for(int u=0; u<500; ++u) {
+    if(inDegree[u] == 0) {
+      ready.push_back(u);
+    }
+  }
+  int sorted = 0;
+  while(!ready.empty()) {
+    const int u = ready.back();
+    ready.pop_back();
+    ++sorted;
+    for(const auto& e: g.edges(u)) {
+      if(--inDegree[e.to] == 0) {
+        ready.push_back(e.to);
+      }
+    }
+  }
+  EXPECT_EQ(sorted, 500);
+}
+
+TEST(GraphGenerator, layeredFlow)
+{
+  auto g = layeredFlow(4, 5, 3, 10, 7).csr<WeightedEdge>();
+  ASSERT_EQ(g.vertices(), 22);
+  EXPECT_EQ(g.edges(0).size(), 5);
+  EXPECT_TRUE(g.edges(21).empty());
+  for(int u=1; u<=5; ++u) {
+    EXPECT_EQ(g.edges(u).size(), 4);
+  }
+  for(int u=16; u<=20; ++u) {
+    EXPECT_EQ(g.edges(u)[0].to, 21);
+  }
+}
+
+TEST(GraphGenerator, bipartiteAndErdosRenyi)
+{
+  // Edges only from [0, left) to [left, left + right), whichever side is larger
+  for(auto [left, right]: {std::make_pair(100, 7), std::make_pair(4, 1000)}) {
+    auto b = bipartite(left, right, 5000, 2).csr();
+    ASSERT_EQ(b.vertices(), left + right);
+    EXPECT_EQ(b.edgeCount(), 5000);
+    for(int u=left; u<left+right; ++u) {
+      EXPECT_TRUE(b.edges(u).empty());
+    }
+    for(const auto& e: b.edgeArray()) {
+      EXPECT_GE(e.to, left);
+      EXPECT_LT(e.to, left + right);
+    }
+    auto g = bipartite(left, right, 5000, 1, 1, 2).graph<GenericGraph<GenericEdge, false>>(2);
+    ASSERT_EQ(g.vertices(), left + right);
+    size_t edges = 0;
+    for(int u=0; u<left+right; ++u) {
+      for(const auto& e: g.edges(u)) {
+        EXPECT_EQ(u < left, e.to >= left);
+        ++edges;
+      }
+    }
+    EXPECT_EQ(edges, 2*5000);
+  }
+
+  // Same edge set whichever representation it is built into
+  auto g = erdosRenyi(300, 2000, 4, 50).graph<GenericGraph<WeightedEdge>>(3);
+  auto csr = erdosRenyi(300, 2000, 4, 50).csr<WeightedEdge>(2);
+  EXPECT_EQ(flatten(g), flatten(csr));
+  for(size_t u=0; u<g.vertices(); ++u) {
+    for(const auto& e: g.edges(u)) {
+      EXPECT_NE(e.to, u);
+    }
+  }
+}
+
+TEST(GraphGenerator, outOfRange)
+{
+  std::vector<EdgeBatch> batches(2);
+  batches[0].add(0, 1, 1);
+  batches[1].add(1, 3, 1);
+  EXPECT_THROW(buildGraph<GenericGraph<>>(3, batches, false, 2), std::out_of_range);
+  batches[1].edges[0] = {-1, 0, 1};
+  EXPECT_THROW(buildCsr<GenericEdge>(3, batches, true, 2), std::out_of_range);
+}
+
+TEST(GraphGenerator, DISABLED_benchmark)
+{
+  for(unsigned threads: {1u, hardwareThreads()}) {
+    auto start = std::chrono::steady_clock::now();
+    auto g = rmat(22, 16, 1, 1000, 0.57, 0.19, 0.19, threads).csr<WeightedEdge>(threads);
+    std::cout << threads << " threads: " << g.edgeCount() << " edges in "
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << "ms" << std::endl;
+  }
+}
+
+} // namespace generate
+} // namespace algo
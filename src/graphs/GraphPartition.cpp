@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <GraphGenerator.hpp>
+#include <GraphPartition.hpp>
+
+namespace algo {
+namespace partition {
+namespace {
+
+using Graph = GenericGraph<WeightedEdge>;
+
+// Every edge in exactly one part, the one its grid position asks for
+template<typename P>
+void checkCover(const Graph& g, const P& p)
+{
+  std::vector<std::tuple<int, int, int>> expected, actual;
+  for(size_t u=0; u<g.vertices(); ++u) {
+    for(const auto& e: g.edges(u)) {
+      expected.emplace_back(u, e.to, e.weight);
+    }
+  }
+  for(int i=0; i<p.count(); ++i) {
+    const auto& part = p.parts[i];
+    for(int u=part.firstSource; u<part.lastSource; ++u) {
+      EXPECT_GE(i, p.firstHolder(u));
+      EXPECT_LT(i, p.lastHolder(u));
+      for(const auto& e: part.out(u)) {
+        EXPECT_EQ(p.colRanges.of(e.to), i % p.cols);
+        actual.emplace_back(u, e.to, e.weight);
+      }
+    }
+  }
+  std::sort(expected.begin(), expected.end());
+  std::sort(actual.begin(), actual.end());
+  EXPECT_EQ(actual, expected);
+}
+
+} // namespace
+
+TEST(GraphPartition, ranges)
+{
+  Ranges r = even(10, 3);
+  EXPECT_THAT(r.first, testing::ElementsAre(0, 3, 6, 10));
+  EXPECT_EQ(r.of(0), 0);
+  EXPECT_EQ(r.of(3), 1);
+  EXPECT_EQ(r.of(9), 2);
+
+  // Heavy first vertex gets a range of its own
+  Ranges b = balanced(10, 3, [](int v) { return v == 0 ? 100 : 0; });
+  EXPECT_EQ(b.count(), 3);
+  EXPECT_EQ(b.end(0), 1);
+  EXPECT_EQ(b.end(2), 10);
+}
+
+TEST(GraphPartition, oneD)
+{
+  Graph g = generate::rmat(9, 8, 1, 10).graph<Graph>();
+  for(int k: {1, 3, 4}) {
+    auto p = oneD(g, k);
+    ASSERT_EQ(p.count(), k);
+    EXPECT_EQ(p.cols, 1);
+    for(size_t u=0; u<g.vertices(); ++u) {
+      EXPECT_EQ(p.firstHolder(u), p.owner(u));
+    }
+    checkCover(g, p);
+  }
+}
+
+TEST(GraphPartition, twoD)
+{
+  Graph g = generate::erdosRenyi(300, 2000, 2, 10).graph<Graph>();
+  auto p = twoD(g, 6);
+  EXPECT_EQ(p.rows, 2);
+  EXPECT_EQ(p.cols, 3);
+  checkCover(g, p);
+  EXPECT_THROW(twoD(g, 20, 20), std::invalid_argument);
+  EXPECT_THROW(twoD(g, 0), std::invalid_argument);
+  EXPECT_THROW(twoD(g, -4), std::invalid_argument);
+}
+
+} // namespace partition
+} // namespace algo
@@ -0,0 +1,121 @@
+#include <chrono>
+#include <fstream>
+#include <random>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <GraphReader.hpp>
+#include <TestFiles.hpp>
+
+namespace algo {
+namespace {
+
+template<typename G>
+std::vector<std::vector<std::pair<int, int>>> dump(const G& g)
+{
+  std::vector<std::vector<std::pair<int, int>>> result(g.vertices());
+  for(size_t u=0; u<g.vertices(); ++u) {
+    for(const auto& e: g.edges(u)) {
+      result[u].emplace_back(e.to, e.weight);
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+TEST(GraphReader, edgeList)
+{
+  std::mt19937 gen(11);
+  std::uniform_int_distribution<int> node(0, 299);
+  std::uniform_int_distribution<int> weight(1, 1000);
+  std::string text = "# random graph\n";
+  GenericGraph<WeightedEdge> directed(300);
+  GenericGraph<WeightedEdge, false> undirected(300);
+  for(int i=0; i<3000; ++i) {
+    const int u = node(gen);
+    const int v = node(gen);
+    const int w = weight(gen);
+    directed.connect(u, v, w);
+    undirected.connect(u, v, w);
+    text += std::to_string(u) + (i % 2 ? "\t" : " ") + std::to_string(v) + " " + std::to_string(w) + (i % 3 ? "\n" : "\r\n");
+  }
+  const test::TempFile file("edges.txt", text);
+  for(unsigned threads: {1, 2, 3, 8}) {
+    EXPECT_EQ(dump(readEdgeList<GenericGraph<WeightedEdge>>(file.path(), threads)), dump(directed));
+    EXPECT_EQ(dump(readEdgeList<GenericGraph<WeightedEdge, false>>(file.path(), threads)), dump(undirected));
+  }
+}
+
+TEST(GraphReader, unweighted)
+{
+  const test::TempFile file("unweighted.txt", "0 1\n% comment\n1 2\n\n2 0");
+  auto g = readEdgeList<GenericGraph<>>(file.path(), 4);
+  ASSERT_EQ(g.vertices(), 3);
+  EXPECT_EQ(g.edges(0)[0].to, 1);
+  EXPECT_EQ(g.edges(1)[0].to, 2);
+  EXPECT_EQ(g.edges(2)[0].to, 0);
+}
+
+TEST(GraphReader, metis)
+{
+  const test::TempFile file("metis.graph", std::string("% comment\n") + test::METIS_EXAMPLE);
+  for(unsigned threads: {1, 3, 16}) {
+    auto g = readMetis<GenericGraph<WeightedEdge>>(file.path(), threads);
+    ASSERT_EQ(g.vertices(), 7);
+    EXPECT_THAT(dump(g)[3], testing::ElementsAre(std::make_pair(1, 1), std::make_pair(2, 2), std::make_pair(5, 2), std::make_pair(6, 5)));
+    size_t edges = 0;
+    for(int u=0; u<7; ++u) {
+      edges += g.edges(u).size();
+    }
+    EXPECT_EQ(edges, 22);
+  }
+
+  // Vertex weights are skipped, empty line is an isolated vertex
+  const test::TempFile file2("metis2.graph", "3 1 010\n4 2\n7 1\n0\n");
+  auto g = readMetis<GenericGraph<>>(file2.path(), 2);
+  ASSERT_EQ(g.vertices(), 3);
+  EXPECT_EQ(g.edges(0)[0].to, 1);
+  EXPECT_EQ(g.edges(1)[0].to, 0);
+  EXPECT_TRUE(g.edges(2).empty());
+}
+
+TEST(GraphReader, malformed)
+{
+  const test::TempFile file("malformed.txt");
+  for(const char* text: {"0 1\n1 x\n", "0 1 2 x\n", "0 99999999999999999999\n", "0 1 3000000000\n"}) {
+    file.write(text);
+    EXPECT_THROW(readEdgeList<GenericGraph<WeightedEdge>>(file.path()), std::runtime_error) << text;
+  }
+  for(const char* text: {"p sp 2 1\na 1 3 5\n", "p sp 2 1\na 1 2 99999999999999999999\n", "p sp 99999999999999999999 1\n"}) {
+    file.write(text);
+    EXPECT_THROW(readDimacs<GenericGraph<WeightedEdge>>(file.path()), std::runtime_error) << text;
+  }
+  file.write("2 1 001\n2 99999999999999999999\n1 1\n");
+  EXPECT_THROW(readMetis<GenericGraph<WeightedEdge>>(file.path()), std::runtime_error);
+
+  EXPECT_THROW(readEdgeList<GenericGraph<>>("/nonexistent/graph"), std::runtime_error);
+}
+
+TEST(GraphReader, DISABLED_benchmark)
+{
+  const test::TempFile file("reader_benchmark.txt");
+  {
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<int> node(0, (1 << 22) - 1);
+    std::uniform_int_distribution<int> weight(1, 1000);
+    std::ofstream out(file.path());
+    out << "p sp " << (1 << 22) << " " << (1 << 25) << "\n";
+    for(int i=0; i<(1 << 25); ++i) {
+      out << "a " << node(gen)+1 << " " << node(gen)+1 << " " << weight(gen) << "\n";
+    }
+  }
+  for(unsigned threads: {1u, 2u, 4u, hardwareThreads()}) {
+    auto start = std::chrono::steady_clock::now();
+    auto g = readDimacs<GenericGraph<WeightedEdge>>(file.path(), threads);
+    std::cout << threads << " threads: " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << "ms" << std::endl;
+  }
+}
+
+} // namespace algo
@@ -0,0 +1,142 @@
+#include <chrono>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <GraphGenerator.hpp>
+#include <GraphReorder.hpp>
+
+namespace algo {
+namespace reorder {
+namespace {
+
+using Graph = GenericGraph<WeightedEdge>;
+
+bool isPermutation(const Permutation& p)
+{
+  std::vector<bool> seen(p.size(), false);
+  for(int v: p) {
+    if(v < 0 || v >= static_cast<int>(p.size()) || seen[v]) {
+      return false;
+    }
+    seen[v] = true;
+  }
+  return true;
+}
+
+std::vector<int> bfsParents(Graph& g, int source)
+{
+  Graph::TraversalState state(g.vertices());
+  g.bfsImpl(source, state);
+  return state.parent;
+}
+
+// Fraction of edges whose endpoints are at most window ids apart, what Gorder maximises
+double windowLocality(const Graph& g, const Permutation& p, int window)
+{
+  size_t close = 0, edges = 0;
+  for(size_t u=0; u<g.vertices(); ++u) {
+    for(const auto& e: g.edges(u)) {
+      close += std::abs(p[u] - p[e.to]) <= window;
+      ++edges;
+    }
+  }
+  return static_cast<double>(close) / edges;
+}
+
+Graph scrambledGrid(int rows, int cols, unsigned seed)
+{
+  Graph g = generate::grid(rows, cols, seed, 100).graph<Graph>();
+  return relabel(g, randomOrder(g.vertices(), seed));
+}
+
+} // namespace
+
+TEST(GraphReorder, permutations)
+{
+  Graph g = generate::erdosRenyi(500, 3000, 1, 10).graph<Graph>();
+  EXPECT_TRUE(isPermutation(degreeOrder(g)));
+  EXPECT_TRUE(isPermutation(reverseCuthillMcKee(g)));
+  EXPECT_TRUE(isPermutation(gorder(g)));
+
+  const Permutation p = degreeOrder(g);
+  const Permutation old = inverse(p);
+  for(int v=1; v<500; ++v) {
+    EXPECT_GE(g.edges(old[v-1]).size(), g.edges(old[v]).size());
+  }
+}
+
+TEST(GraphReorder, locality)
+{
+  Graph g = scrambledGrid(40, 50, 2);
+  Permutation identity(g.vertices());
+  std::iota(identity.begin(), identity.end(), 0);
+  const double scrambled = averageGap(g, identity);
+  // Grid rows are 50 apart, a banded order gets close to that
+  EXPECT_LT(averageGap(g, reverseCuthillMcKee(g)), 60);
+  EXPECT_LT(averageGap(g, reverseCuthillMcKee(g)), scrambled / 10);
+  EXPECT_LT(windowLocality(g, identity, 5), 0.05);
+  EXPECT_GT(windowLocality(g, gorder(g, 5), 5), 0.5);
+}
+
+TEST(GraphReorder, relabelAndRestore)
+{
+  Graph g = generate::erdosRenyi(300, 1500, 3, 10).graph<Graph>();
+  for(const Permutation& p: {reverseCuthillMcKee(g), gorder(g), randomOrder(300, 4)}) {
+    Graph r = relabel(g, p);
+    for(int u=0; u<300; ++u) {
+      ASSERT_EQ(r.edges(p[u]).size(), g.edges(u).size());
+      for(size_t i=0; i<g.edges(u).size(); ++i) {
+        EXPECT_EQ(r.edges(p[u])[i].to, p[g.edges(u)[i].to]);
+        EXPECT_EQ(r.edges(p[u])[i].weight, g.edges(u)[i].weight);
+      }
+    }
+    // Adjacency order is kept, so BFS discovers the same tree
+    EXPECT_EQ(restoreIds(bfsParents(r, p[7]), p), bfsParents(g, 7));
+
+    auto csr = generate::erdosRenyi(300, 1500, 3, 10).csr<WeightedEdge>();
+    auto rcsr = relabel(csr, p, 3);
+    for(int u=0; u<300; ++u) {
+      ASSERT_EQ(rcsr.edges(p[u]).size(), csr.edges(u).size());
+      for(size_t i=0; i<csr.edges(u).size(); ++i) {
+        EXPECT_EQ(rcsr.edges(p[u])[i].to, p[csr.edges(u)[i].to]);
+      }
+    }
+  }
+}
+
+// Runs on CSR, with vector<vector> adjacency every list lives where it was allocated and
+// only the per-vertex arrays benefit from the new order
+TEST(GraphReorder, DISABLED_benchmark)
+{
+  auto grid = generate::grid(2000, 2000, 5, 100).csr<WeightedEdge>();
+  auto g = relabel(grid, randomOrder(grid.vertices(), 5));
+  auto time = [](const CsrGraph<WeightedEdge>& graph, int source) {
+    std::vector<int> depth(graph.vertices());
+    std::vector<int> queue(graph.vertices());
+    auto start = std::chrono::steady_clock::now();
+    for(int i=0; i<3; ++i) {
+      std::fill(depth.begin(), depth.end(), -1);
+      size_t head = 0, tail = 0;
+      depth[source] = 0;
+      queue[tail++] = source;
+      while(head < tail) {
+        const int u = queue[head++];
+        for(const auto& e: graph.edges(u)) {
+          if(depth[e.to] < 0) {
+            depth[e.to] = depth[u] + 1;
+            queue[tail++] = e.to;
+          }
+        }
+      }
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / 3;
+  };
+  std::cout << "scrambled: " << time(g, 0) << "ms" << std::endl;
+  for(const auto& [name, p]: {std::make_pair("degree", degreeOrder(g)), std::make_pair("rcm", reverseCuthillMcKee(g)), std::make_pair("gorder", gorder(g))}) {
+    std::cout << name << ": " << time(relabel(g, p), p[0]) << "ms, average gap " << averageGap(g, p) << std::endl;
+  }
+}
+
+} // namespace reorder
+} // namespace algo
@@ -1,264 +1,516 @@
+#include <array>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <type_traits>
+
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
 #include <Graph.hpp>
 #include <Matrix.hpp>
+#include <Parallel.hpp>
 
 namespace algo {
 namespace hungarian {
 
-struct ResidualEdge
+using Assignment = std::vector<int>; // Column assigned to every row, -1 if none
+
+// Potentials are kept in a wider type for integral costs, floating point costs are
+// compared with a relative epsilon.
+template<typename Cost>
+struct CostTraits
 {
-  ResidualEdge(int t, int r): to(t), residual(r) {}
+  using Value = std::conditional_t<std::is_floating_point<Cost>::value, Cost, long long>;
+
+  static constexpr Value infinity()
+  {
+    return std::numeric_limits<Value>::has_infinity ? std::numeric_limits<Value>::infinity() : std::numeric_limits<Value>::max();
+  }
+
+  static bool less(Value a, Value b)
+  {
+    if constexpr(std::is_floating_point<Value>::value) {
+      return a < b - epsilon * std::max<Value>(1, std::abs(b));
+    } else {
+      return a < b;
+    }
+  }
 
-  int to;
-  int residual;
-  int flow = 0;
+  static constexpr Value epsilon = std::is_floating_point<Value>::value ? Value(1e-9) : Value(0);
 };
 
-struct ResidualFlowGraph: public GenericGraph<ResidualEdge>
+// Assignment of the transposed problem mapped back to rows
+inline Assignment invert(const Assignment& a, size_t rows)
 {
-  ResidualFlowGraph(size_t s): GenericGraph(s) {}
-
-  int volume(const VerticeList& path) const
-  {
-    int result = std::numeric_limits<int>::max();
-    for(int i=0; i<path.size()-1;++i) {
-      int u = path[i];
-      int v = path[i+1];
-      for(const ResidualEdge& e: adjacency[u]) {
-        if(e.to == v) {
-          result = std::min(result, e.residual);
-          break;
-        }
-      }
+  Assignment result(rows, -1);
+  for(size_t j=0; j<a.size(); ++j) {
+    if(a[j] >= 0) {
+      result[a[j]] = j;
     }
-    return result;
   }
+  return result;
+}
 
-  void augment(const VerticeList& path, int vol)
-  {
-    for(int i=0; i<path.size()-1;++i) {
-      int u = path[i];
-      int v = path[i+1];
-      for(ResidualEdge& e: adjacency[u]) {
-        if(e.to == v) {
-          e.flow += vol;
-          e.residual -= vol;
-          break;
+// Kuhn-Munkres with row/column potentials on row-major costs, n <= m. Rows are added one
+// at a time, each by a Dijkstra-like shortest augmenting path search over reduced costs,
+// O(n^2 m) overall. Scratch arrays are provided by the caller: u has n+1 elements, the
+// rest m+1. Column assigned to every row is written to assignment.
+template<typename Cost, typename Value>
+void kuhnMunkres(const Cost* cost, size_t n, size_t m, Value* u, Value* v, int* match, int* way,
+  Value* minv, bool* used, int* assignment)
+{
+  constexpr Value INF = CostTraits<Cost>::infinity();
+
+  // Index 0 is a virtual column used as the root of every search, match holds 1-based
+  // rows assigned to columns and 0 for free ones, way the previous column on the path.
+  std::fill(u, u+n+1, 0);
+  std::fill(v, v+m+1, 0);
+  std::fill(match, match+m+1, 0);
+  std::fill(way, way+m+1, 0);
+
+  for(size_t i=1; i<=n; ++i) {
+    match[0] = i;
+    int j0 = 0;
+    std::fill(minv, minv+m+1, INF);
+    std::fill(used, used+m+1, false);
+    do {
+      used[j0] = true;
+      const int i0 = match[j0];
+      const Cost* row = cost + (i0-1)*m;
+      Value delta = INF;
+      int j1 = 0;
+      for(size_t j=1; j<=m; ++j) {
+        if(!used[j]) {
+          const Value cur = row[j-1] - u[i0] - v[j];
+          if(cur < minv[j]) {
+            minv[j] = cur;
+            way[j] = j0;
+          }
+          if(minv[j] < delta) {
+            delta = minv[j];
+            j1 = j;
+          }
         }
       }
-      for(ResidualEdge& e: adjacency[v]) {
-        if(e.to == u) {
-          e.residual += vol;
-          e.flow -= vol;
-          break;
+      for(size_t j=0; j<=m; ++j) {
+        if(used[j]) {
+          u[match[j]] += delta;
+          v[j] -= delta;
+        } else {
+          minv[j] -= delta;
         }
       }
+      j0 = j1;
+    } while(match[j0] != 0);
+
+    // Flip the alternating path back to the root
+    do {
+      const int j1 = way[j0];
+      match[j0] = match[j1];
+      j0 = j1;
+    } while(j0 != 0);
+  }
+
+  std::fill(assignment, assignment+n, -1);
+  for(size_t j=1; j<=m; ++j) {
+    if(match[j] != 0) {
+      assignment[match[j]-1] = j-1;
     }
   }
+}
 
-  int flow(int u, int v) const
-  {
-    for(const ResidualEdge& e: adjacency[u]) {
-      if(e.to == v) {
-        return e.flow;
+// With more rows than columns the transposed problem is solved
+template<typename Cost>
+Assignment denseAssignment(const Cost* cost, size_t n, size_t m)
+{
+  using Value = typename CostTraits<Cost>::Value;
+
+  if(n > m) {
+    std::vector<Cost> t(n*m);
+    for(size_t i=0; i<n; ++i) {
+      for(size_t j=0; j<m; ++j) {
+        t[j*n + i] = cost[i*m + j];
       }
     }
-    return -1;
+    return invert(denseAssignment(t.data(), m, n), n);
   }
-};  
 
-struct BipartiteGraph
+  std::vector<Value> u(n+1);
+  std::vector<Value> v(m+1);
+  std::vector<int> match(m+1);
+  std::vector<int> way(m+1);
+  std::vector<Value> minv(m+1);
+  std::unique_ptr<bool[]> used(new bool[m+1]);
+  Assignment assignment(n);
+  kuhnMunkres(cost, n, m, u.data(), v.data(), match.data(), way.data(), minv.data(), used.get(), assignment.data());
+  return assignment;
+}
+
+template<typename Cost>
+Assignment denseAssignment(const Matrix<Cost>& costs)
 {
-  using Flags=std::vector<bool>;
+  return denseAssignment(costs.data(), costs.height(), costs.width());
+}
 
-  BipartiteGraph(size_t l, size_t r): _M(l,r,-1) 
+// Cost matrix in compressed sparse row form, missing pairs are forbidden
+template<typename Cost>
+struct SparseCosts
+{
+  SparseCosts(size_t r, size_t c): rows(0), cols(c), offset(1, 0) 
   {
+    offset.reserve(r+1);
   }
 
-  void set(size_t i, const std::vector<int>& adj) 
+  // Rows are appended in order, entries are (column, cost) pairs
+  void addRow(const std::vector<std::pair<int, Cost>>& entries)
   {
-    for(int j=0; j<adj.size(); ++j) {
-      _M(i,j) = adj[j];
+    for(const auto& [j, c]: entries) {
+      column.push_back(j);
+      cost.push_back(c);
     }
+    offset.push_back(column.size());
+    ++rows;
   }
 
-  using Assignment = std::vector<int>;
-
-  void assign(const Matrix<int>& M, Assignment& a)
+  SparseCosts transpose() const
   {
-    const size_t H = M.height();
-    const size_t W = M.width();
-    const size_t rgSize = H + W + 2;
-
-    // Create residual flow graph
-    ResidualFlowGraph rg(rgSize);
-    int source = rgSize-2;
-    int sink = rgSize-1;
-    for(int i=0; i<H; ++i) {
-      for(int j=0;j<W;++j) {
-        if(M(i,j) == 0) {
-          rg.connect(i, j+H, 1);
-          rg.connect(j+H, i, 0);
-        }  
-      }
-      rg.connect(source, i, 1);
+    SparseCosts t(cols, rows);
+    t.rows = cols;
+    t.offset.assign(cols+1, 0);
+    for(int j: column) {
+      ++t.offset[j+1];
     }
-    for(int j=0;j<W;++j) {
-      rg.connect(j+H, sink, 1);
+    std::partial_sum(t.offset.begin(), t.offset.end(), t.offset.begin());
+    t.column.resize(column.size());
+    t.cost.resize(cost.size());
+    std::vector<int> pos(t.offset.begin(), t.offset.end()-1);
+    for(size_t i=0; i<rows; ++i) {
+      for(int k=offset[i]; k<offset[i+1]; ++k) {
+        const int p = pos[column[k]]++;
+        t.column[p] = i;
+        t.cost[p] = cost[k];
+      }
     }
+    return t;
+  }
 
-    struct State: public ResidualFlowGraph::TraversalState
-    {
-      State(size_t s): ResidualFlowGraph::TraversalState(s) {}
+  size_t rows;
+  size_t cols;
+  std::vector<int> offset;
+  std::vector<int> column;
+  std::vector<Cost> cost;
+};
 
-      bool validEdge(const ResidualEdge& e)
-      {
-        return e.residual > 0;
-      }
-    };
+// Shortest augmenting paths over the non-zeros only: Dijkstra with a binary heap on columns,
+// duals are updated just for the rows and columns a search has touched. Rows which cannot
+// be assigned through allowed pairs are left at -1, cost optimality is guaranteed when
+// every row of the smaller side is assigned.
+template<typename Cost>
+Assignment sparseAssignment(const SparseCosts<Cost>& c)
+{
+  using Traits = CostTraits<Cost>;
+  using Value = typename Traits::Value;
+  constexpr Value INF = Traits::infinity();
 
-    State state(rgSize);
-    rg.bfsImpl(source, state);
-    auto augmentingPath = rg.buildPath(source, sink, state.parent);
-    // for(int i: augmentingPath) { std::cout << i << "->"; } std::cout << std::endl;
-
-    while(!augmentingPath.empty()) {
-      int augmentingVolume = rg.volume(augmentingPath);
-      rg.augment(augmentingPath, augmentingVolume);
-      state.reset();
-      rg.bfsImpl(source, state);
-      augmentingPath = rg.buildPath(source, sink, state.parent);
-      // for(int i: augmentingPath) { std::cout << i << "->"; } std::cout << std::endl;
+  if(c.rows > c.cols) {
+    return invert(sparseAssignment(c.transpose()), c.rows);
+  }
+
+  const size_t n = c.rows;
+  const size_t m = c.cols;
+  std::vector<Value> u(n, 0);
+  std::vector<Value> v(m, 0);
+  std::vector<int> matchRow(n, -1);
+  std::vector<int> matchCol(m, -1);
+  std::vector<Value> dist(m, INF);
+  std::vector<int> way(m, -1);     // row from which column was reached
+  std::vector<bool> done(m, false);
+  std::vector<int> touched;
+  std::vector<int> scanned;
+
+  // Row reduction gives feasible duals for arbitrary signs of costs. Free columns have to
+  // share the same potential, otherwise the closest free column is not the cheapest one.
+  for(size_t i=0; i<n; ++i) {
+    if(c.offset[i] < c.offset[i+1]) {
+      u[i] = *std::min_element(c.cost.begin() + c.offset[i], c.cost.begin() + c.offset[i+1]);
     }
+  }
 
-    a.assign(H, -1);
-    for(int i=0; i<H; ++i) {
-      for(int j=0; j<W; ++j) {
-        if(rg.flow(i, j+H) > 0) {
-          a[i] = j;
+  using Item = std::pair<Value, int>;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> heap;
+
+  for(int root=0; root<static_cast<int>(n); ++root) {
+    touched.clear();
+    scanned.clear();
+    heap = decltype(heap)();
+
+    int row = root;
+    Value rowDist = 0;
+    int freeCol = -1;
+    Value total = 0;
+    while(true) {
+      scanned.push_back(row);
+      for(int k=c.offset[row]; k<c.offset[row+1]; ++k) {
+        const int j = c.column[k];
+        if(done[j]) {
+          continue;
+        }
+        const Value reduced = std::max<Value>(0, c.cost[k] - u[row] - v[j]);
+        const Value d = rowDist + reduced;
+        if(dist[j] == INF) {
+          touched.push_back(j);
+        }
+        if(dist[j] == INF || Traits::less(d, dist[j])) {
+          dist[j] = d;
+          way[j] = row;
+          heap.push({d, j});
+        }
+      }
+
+      // Closest column not finished yet
+      int j = -1;
+      while(!heap.empty()) {
+        const auto [d, k] = heap.top();
+        heap.pop();
+        if(!done[k] && d == dist[k]) {
+          j = k;
           break;
         }
       }
+      if(j < 0) {
+        break;
+      }
+      done[j] = true;
+      if(matchCol[j] < 0) {
+        freeCol = j;
+        total = dist[j];
+        break;
+      }
+      row = matchCol[j];
+      rowDist = dist[j];
     }
-  }
 
-  void crossOut(Matrix<int>& M, const Assignment& a)
-  {
-    const size_t H = M.height();
-    const size_t W = M.width();
-
-    Flags markedRows(H, false);
-    Flags markedCols(W, false);
-
-    Assignment aux = a;
-
-    bool done = false;
-    while(!done) {
-      done = true;
-      for(int i=0; i<H; ++i) {
-        // Mark rows having no assignment
-        if(aux[i] == -1) {
-          aux[i] = -2;
-          done = false;
-          // std::cout << "Marking row " << i << std::endl;
-          markedRows[i] = true;
-          const auto& row = M.row(i);
-          // Mark all (unmarked) columns having zeros in newly marked row
-          for(int j=0; j<W; ++j) {
-            if(row[j] == 0) {
-              if(!markedCols[j]) {
-                // std::cout << "Marking column " << j << std::endl;
-                markedCols[j] = true;
-                // Mark all rows having assignments in newly marked columns
-                for(int k=0; k<H; ++k) {
-                  if(aux[k] == j) {
-                    aux[k] = -1;
-                  }
-                }
-              }
-            }
-          }
+    if(freeCol >= 0) {
+      // Keep matched pairs tight and every other reduced cost non-negative
+      for(int r: scanned) {
+        const int j = matchRow[r];
+        const Value d = (r == root) ? 0 : dist[j];
+        u[r] += total - d;
+      }
+      for(int j: touched) {
+        if(done[j]) {
+          v[j] -= total - dist[j];
         }
       }
+      for(int j=freeCol; j>=0; ) {
+        const int r = way[j];
+        const int previous = matchRow[r];
+        matchRow[r] = j;
+        matchCol[j] = r;
+        j = previous;
+      }
     }
 
-    // Cross out marked columns and unmarked rows
-    for(int i=0; i<H; ++i) {
-      markedRows[i] = !markedRows[i];
+    for(int j: touched) {
+      dist[j] = INF;
+      done[j] = false;
     }
+  }
+  return matchRow;
+}
 
-    // From remaining elements find the minimum
-    int minVal = std::numeric_limits<int>::max();
-    for(int i=0; i<H; ++i) {
-      if(markedRows[i]) {
-        continue;
-      }
-      for(int j=0; j<W; ++j) {
-        if(!markedCols[j] && M(i,j) < minVal) {
-          minVal = M(i,j);
+// Bertsekas auction with epsilon scaling for square problems. Costs are negated into
+// benefits and multiplied by n+1, so that the final 1-complementary slackness gives an
+// optimal assignment. Rounds are Jacobi style: all unassigned rows bid in parallel on
+// the prices of the previous round, then every object goes to its highest bidder.
+template<typename Cost>
+Assignment auctionAssignment(const Cost* cost, size_t n, size_t m, unsigned threads = hardwareThreads(), int alpha = 7)
+{
+  using Value = typename CostTraits<Cost>::Value;
+
+  if(n != m) {
+    throw std::invalid_argument("Auction requires a square cost matrix");
+  }
+  if(alpha <= 1) {
+    throw std::invalid_argument("Epsilon scaling factor must be above 1");
+  }
+  threads = std::max(1u, threads);
+
+  const Value scale = std::is_floating_point<Value>::value ? Value(1) : Value(n+1);
+  Value maxAbs = 0;
+  for(size_t k=0; k<n*m; ++k) {
+    maxAbs = std::max<Value>(maxAbs, std::abs(static_cast<Value>(cost[k])));
+  }
+  // Floating point costs end up within n * finalEps of the optimum
+  const Value finalEps = std::is_floating_point<Value>::value ? std::max<Value>(maxAbs, 1) / (n+1) * Value(1e-6) : Value(1);
+
+  auto benefit = [&](int i, int j) {
+    return -static_cast<Value>(cost[i*m + j]) * scale;
+  };
+
+  std::vector<Value> price(m, 0);
+  std::vector<int> owner(m, -1);
+  Assignment assignment(n, -1);
+  std::vector<int> unassigned;
+  std::vector<int> bidObject(n);
+  std::vector<Value> bidValue(n);
+  std::vector<int> bestBidder(m, -1);
+  std::vector<int> bidObjects;
+  std::vector<int> next;
+
+  Value eps = std::max(finalEps, maxAbs*scale / alpha);
+  Barrier barrier(threads);
+  bool done = false;
+
+  while(true) {
+    std::fill(owner.begin(), owner.end(), -1);
+    std::fill(assignment.begin(), assignment.end(), -1);
+    unassigned.resize(n);
+    std::iota(unassigned.begin(), unassigned.end(), 0);
+    done = false;
+
+    parallelRun(threads, [&](unsigned id) {
+      while(true) {
+        barrier.wait();
+        if(done) {
+          break;
+        }
+        // Bidding
+        const size_t begin = unassigned.size()*id/threads;
+        const size_t end = unassigned.size()*(id+1)/threads;
+        for(size_t k=begin; k<end; ++k) {
+          const int i = unassigned[k];
+          Value best = std::numeric_limits<Value>::lowest();
+          Value second = std::numeric_limits<Value>::lowest();
+          int object = 0;
+          for(size_t j=0; j<m; ++j) {
+            const Value v = benefit(i, j) - price[j];
+            if(v > best) {
+              second = best;
+              best = v;
+              object = j;
+            } else if(v > second) {
+              second = v;
+            }
+          }
+          if(m == 1) {
+            second = best;
+          }
+          bidObject[i] = object;
+          bidValue[i] = price[object] + best - second + eps;
+        }
+        barrier.wait();
+
+        // Assignment of objects to the highest bidders
+        if(id == 0) {
+          bidObjects.clear();
+          for(int i: unassigned) {
+            const int j = bidObject[i];
+            if(bestBidder[j] < 0) {
+              bidObjects.push_back(j);
+              bestBidder[j] = i;
+            } else if(bidValue[i] > bidValue[bestBidder[j]]) {
+              bestBidder[j] = i;
+            }
+          }
+          next.clear();
+          for(int j: bidObjects) {
+            const int i = bestBidder[j];
+            if(owner[j] >= 0) {
+              assignment[owner[j]] = -1;
+              next.push_back(owner[j]);
+            }
+            owner[j] = i;
+            assignment[i] = j;
+            price[j] = bidValue[i];
+            bestBidder[j] = -1;
+          }
+          for(int i: unassigned) {
+            if(assignment[i] < 0) {
+              next.push_back(i);
+            }
+          }
+          unassigned.swap(next);
+          done = unassigned.empty();
         }
       }
+    });
+
+    if(eps <= finalEps) {
+      break;
     }
+    eps = std::max(finalEps, eps / alpha);
+  }
+  return assignment;
+}
 
-    // Subtract min from every unmarked element and add it to every element covered by two lines.
-    for(int i=0; i<H; ++i) {
-      for(int j=0; j<W; ++j) {
-        if(markedRows[i] && markedCols[j]) {
-          M(i,j) += minVal;
-        } else if(!markedRows[i] && !markedCols[j]) {
-          M(i,j) -= minVal;
-        }
-      }
+template<typename Cost>
+Assignment auctionAssignment(const Matrix<Cost>& costs, unsigned threads = hardwareThreads())
+{
+  return auctionAssignment(costs.data(), costs.height(), costs.width(), threads);
+}
+
+// Many small N x N problems stored back to back in costs, assignments receive N columns
+// per problem. Scratch space is sized at compile time and lives on the stack of the worker
+// threads, so solving does not allocate per problem.
+template<size_t N, typename Cost>
+void batchAssignment(const Cost* costs, size_t count, int* assignments, unsigned threads = hardwareThreads())
+{
+  using Value = typename CostTraits<Cost>::Value;
+
+  parallelFor(threads, count, [&](size_t begin, size_t end, unsigned) {
+    std::array<Value, N+1> u;
+    std::array<Value, N+1> v;
+    std::array<int, N+1> match;
+    std::array<int, N+1> way;
+    std::array<Value, N+1> minv;
+    std::array<bool, N+1> used;
+    for(size_t k=begin; k<end; ++k) {
+      kuhnMunkres(costs + k*N*N, N, N, u.data(), v.data(), match.data(), way.data(),
+        minv.data(), used.data(), assignments + k*N);
     }
+  });
+}
+
+// Dense integer assignment for square or rectangular cost matrices
+struct BipartiteGraph
+{
+  BipartiteGraph(size_t l, size_t r): _M(r,l,-1) 
+  {
   }
 
-  auto perfectAssignment() 
+  void set(size_t i, const std::vector<int>& adj) 
   {
-    std::vector<int> assignment(_M.height(), -1);
-
-    Matrix<int> H = _M;
-    
-    // Step 1
-    for(int i=0; i<H.height(); ++i) {
-      const auto& row = H.row(i);
-      int minVal = *std::min_element(row.cbegin(), row.cend());
-      for(int j=0; j<H.width(); ++j) {
-        H(i,j) -= minVal;
-      }
-    }
-    // std::cout << H << std::endl;
-
-    // Step 2
-    for(int j=0; j<H.width(); ++j) {
-      const auto& col = H.column(j);
-      int minVal = *std::min_element(col.cbegin(), col.cend());
-      for(int i=0; i<H.height(); ++i) {
-        H(i,j) -= minVal;
-      }
+    for(size_t j=0; j<adj.size(); ++j) {
+      _M(i,j) = adj[j];
     }
-    // std::cout << H << std::endl;
+  }
 
-    // Step 3
-    int steps = H.width();
-    while(steps--) {
-      assign(H, assignment);
-      if(std::find(assignment.cbegin(), assignment.cend(), -1) == assignment.cend()) {
-        break;
-      }
-      crossOut(H, assignment);
-      // std::cout << H << std::endl;
-    }
+  using Assignment = hungarian::Assignment;
+
+  Assignment perfectAssignment() 
+  {
+    return denseAssignment(_M);
+  }
 
-    return assignment;
+  Assignment auctionAssignment(unsigned threads = hardwareThreads())
+  {
+    return hungarian::auctionAssignment(_M, threads);
   }
 
   int cost(const Assignment& a) 
   {
     int result = 0;
-    for(int i=0; i<_M.height(); ++i) {
-      result += _M(i, a[i]);
+    for(size_t i=0; i<_M.height(); ++i) {
+      if(a[i] >= 0) {
+        result += _M(i, a[i]);
+      }
     }
     return result;
   }
@@ -322,5 +574,272 @@ TEST(Hungarian, test3)
   EXPECT_THAT(g.cost(a), testing::Eq(3));
 }
 
+TEST(Hungarian, bruteForce)
+{
+  std::mt19937 gen(5);
+  std::uniform_int_distribution<int> value(0, 50);
+  for(int test=0; test<20; ++test) {
+    const int n = 6;
+    BipartiteGraph g(n, n);
+    for(int i=0; i<n; ++i) {
+      std::vector<int> row(n);
+      std::generate(row.begin(), row.end(), [&] { return value(gen); });
+      g.set(i, row);
+    }
+
+    BipartiteGraph::Assignment p(n);
+    std::iota(p.begin(), p.end(), 0);
+    int best = std::numeric_limits<int>::max();
+    do {
+      best = std::min(best, g.cost(p));
+    } while(std::next_permutation(p.begin(), p.end()));
+
+    EXPECT_THAT(g.cost(g.perfectAssignment()), testing::Eq(best));
+  }
+}
+
+TEST(Hungarian, rectangular)
+{
+  std::mt19937 gen(9);
+  std::uniform_int_distribution<int> value(0, 50);
+  for(auto [rows, cols]: {std::make_pair(3, 6), std::make_pair(6, 3), std::make_pair(5, 5)}) {
+    Matrix<int> m(cols, rows, 0);
+    for(int i=0; i<rows; ++i) {
+      for(int j=0; j<cols; ++j) {
+        m(i,j) = value(gen);
+      }
+    }
+
+    // Brute force over injective maps of the smaller side
+    const int k = std::min(rows, cols);
+    std::vector<int> p(std::max(rows, cols));
+    std::iota(p.begin(), p.end(), 0);
+    int best = std::numeric_limits<int>::max();
+    do {
+      int c = 0;
+      for(int x=0; x<k; ++x) {
+        c += (rows <= cols) ? m(x, p[x]) : m(p[x], x);
+      }
+      best = std::min(best, c);
+    } while(std::next_permutation(p.begin(), p.end()));
+
+    auto a = denseAssignment(m);
+    ASSERT_THAT(a.size(), testing::Eq(rows));
+    int c = 0;
+    int assigned = 0;
+    for(int i=0; i<rows; ++i) {
+      if(a[i] >= 0) {
+        c += m(i, a[i]);
+        ++assigned;
+      }
+    }
+    EXPECT_THAT(assigned, testing::Eq(k));
+    EXPECT_THAT(c, testing::Eq(best));
+  }
+}
+
+TEST(Hungarian, sparse)
+{
+  std::mt19937 gen(13);
+  std::uniform_int_distribution<int> value(-20, 50);
+  std::bernoulli_distribution allowed(0.3);
+  const int forbidden = 1000000;
+  for(int test=0; test<20; ++test) {
+    const int rows = 8;
+    const int cols = 12;
+    Matrix<long long> dense(cols, rows, forbidden);
+    SparseCosts<long long> sparse(rows, cols);
+    for(int i=0; i<rows; ++i) {
+      std::vector<std::pair<int, long long>> entries;
+      for(int j=0; j<cols; ++j) {
+        // Diagonal keeps the problem feasible
+        if(i == j || allowed(gen)) {
+          dense(i,j) = value(gen);
+          entries.emplace_back(j, dense(i,j));
+        }
+      }
+      sparse.addRow(entries);
+    }
+
+    auto cost = [&](const Assignment& a) {
+      long long c = 0;
+      for(size_t i=0; i<a.size(); ++i) {
+        c += dense(i, a[i]);
+      }
+      return c;
+    };
+    auto a = sparseAssignment(sparse);
+    EXPECT_THAT(std::count(a.begin(), a.end(), -1), testing::Eq(0));
+    EXPECT_THAT(cost(a), testing::Eq(cost(denseAssignment(dense))));
+
+    // Same problem seen from the columns
+    auto t = sparseAssignment(sparse.transpose());
+    EXPECT_THAT(std::count(t.begin(), t.end(), -1), testing::Eq(cols - rows));
+  }
+}
+
+TEST(Hungarian, infeasible)
+{
+  SparseCosts<int> sparse(3, 3);
+  sparse.addRow({{0, 1}});
+  sparse.addRow({{0, 2}});
+  sparse.addRow({{1, 1}, {2, 5}});
+  auto a = sparseAssignment(sparse);
+  EXPECT_THAT(std::count(a.begin(), a.end(), -1), testing::Eq(1));
+  EXPECT_THAT(a[2], testing::Eq(1));
+}
+
+TEST(Hungarian, floatingPoint)
+{
+  Matrix<double> m(3, 3, 0);
+  const double costs[3][3] = {{0.1, 0.2, 0.3}, {0.2, 0.4, 0.6}, {0.3, 0.6, 0.9}};
+  SparseCosts<double> sparse(3, 3);
+  for(int i=0; i<3; ++i) {
+    std::vector<std::pair<int, double>> entries;
+    for(int j=0; j<3; ++j) {
+      m(i,j) = costs[i][j];
+      entries.emplace_back(j, costs[i][j]);
+    }
+    sparse.addRow(entries);
+  }
+  auto cost = [&](const Assignment& a) {
+    return m(0, a[0]) + m(1, a[1]) + m(2, a[2]);
+  };
+  EXPECT_NEAR(cost(denseAssignment(m)), 1.0, 1e-12);
+  EXPECT_NEAR(cost(sparseAssignment(sparse)), 1.0, 1e-12);
+}
+
+TEST(Hungarian, auction)
+{
+  BipartiteGraph g(3,3);
+  g.set(0, {1, 1, 1});
+  g.set(1, {9, 1, 8});
+  g.set(2, {1, 6, 4});
+  EXPECT_THAT(g.auctionAssignment(2), testing::ElementsAre(2,1,0));
+
+  std::mt19937 gen(17);
+  std::uniform_int_distribution<int> value(0, 1000);
+  for(int test=0; test<10; ++test) {
+    const int n = 25;
+    BipartiteGraph r(n, n);
+    for(int i=0; i<n; ++i) {
+      std::vector<int> row(n);
+      std::generate(row.begin(), row.end(), [&] { return value(gen); });
+      r.set(i, row);
+    }
+    const int expected = r.cost(r.perfectAssignment());
+    for(unsigned threads: {0, 1, 3}) {
+      auto a = r.auctionAssignment(threads);
+      EXPECT_THAT(std::set<int>(a.begin(), a.end()).size(), testing::Eq(n));
+      EXPECT_THAT(r.cost(a), testing::Eq(expected));
+    }
+  }
+
+  Matrix<double> m(3, 3, 0);
+  const double costs[3][3] = {{0.1, 0.2, 0.3}, {0.2, 0.4, 0.6}, {0.3, 0.6, 0.9}};
+  for(int i=0; i<3; ++i) {
+    for(int j=0; j<3; ++j) {
+      m(i,j) = costs[i][j];
+    }
+  }
+  auto a = auctionAssignment(m, 2);
+  EXPECT_NEAR(m(0, a[0]) + m(1, a[1]) + m(2, a[2]), 1.0, 1e-6);
+  EXPECT_THROW(auctionAssignment(m.data(), 3, 3, 2, 1), std::invalid_argument);
+  EXPECT_THROW(auctionAssignment(m.data(), 3, 3, 2, 0), std::invalid_argument);
+}
+
+TEST(Hungarian, batch)
+{
+  constexpr size_t N = 8;
+  const size_t count = 200;
+  std::mt19937 gen(23);
+  std::uniform_int_distribution<int> value(0, 100);
+  std::vector<int> costs(count*N*N);
+  std::generate(costs.begin(), costs.end(), [&] { return value(gen); });
+
+  auto cost = [&](size_t k, const int* a) {
+    int c = 0;
+    for(size_t i=0; i<N; ++i) {
+      c += costs[k*N*N + i*N + a[i]];
+    }
+    return c;
+  };
+
+  for(unsigned threads: {1, 4}) {
+    std::vector<int> assignments(count*N, -1);
+    batchAssignment<N>(costs.data(), count, assignments.data(), threads);
+    for(size_t k=0; k<count; ++k) {
+      const Assignment expected = denseAssignment(costs.data() + k*N*N, N, N);
+      EXPECT_THAT(cost(k, &assignments[k*N]), testing::Eq(cost(k, expected.data())));
+    }
+  }
+}
+
+TEST(Hungarian, DISABLED_batchBenchmark)
+{
+  constexpr size_t N = 16;
+  const size_t count = 100000;
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> value(0, 1000);
+  std::vector<int> costs(count*N*N);
+  std::generate(costs.begin(), costs.end(), [&] { return value(gen); });
+  std::vector<int> assignments(count*N);
+
+  for(unsigned threads=1; threads<=hardwareThreads(); threads*=2) {
+    auto start = std::chrono::steady_clock::now();
+    batchAssignment<N>(costs.data(), count, assignments.data(), threads);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << count << " problems " << N << "x" << N << ", " << threads << " threads: " << elapsed.count() << " ms" << std::endl;
+  }
+}
+
+TEST(Hungarian, DISABLED_sparseBenchmark)
+{
+  const int rows = 5000;
+  const int cols = 200000;
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> column(0, cols-1);
+  std::uniform_real_distribution<double> value(0, 1000);
+  SparseCosts<double> sparse(rows, cols);
+  for(int i=0; i<rows; ++i) {
+    std::vector<std::pair<int, double>> entries;
+    for(int k=0; k<20; ++k) {
+      entries.emplace_back(column(gen), value(gen));
+    }
+    sparse.addRow(entries);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  auto a = sparseAssignment(sparse);
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  std::cout << rows << "x" << cols << " with " << sparse.column.size() << " pairs: "
+    << std::count(a.begin(), a.end(), -1) << " unassigned in " << elapsed.count() << " ms" << std::endl;
+}
+
+TEST(Hungarian, DISABLED_benchmark)
+{
+  const int n = 2000;
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> value(0, 1000000);
+  BipartiteGraph g(n, n);
+  std::vector<int> row(n);
+  for(int i=0; i<n; ++i) {
+    std::generate(row.begin(), row.end(), [&] { return value(gen); });
+    g.set(i, row);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  auto a = g.perfectAssignment();
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  std::cout << n << "x" << n << ": cost " << g.cost(a) << " in " << elapsed.count() << " ms" << std::endl;
+
+  for(unsigned threads=1; threads<=hardwareThreads(); threads*=2) {
+    start = std::chrono::steady_clock::now();
+    a = g.auctionAssignment(threads);
+    elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "auction, " << threads << " threads: cost " << g.cost(a) << " in " << elapsed.count() << " ms" << std::endl;
+  }
+}
+
 } // namspace hungarian
 } // namespace algo
\ No newline at end of file
@@ -5,6 +5,7 @@
 
 #include <Graph.hpp>
 #include <Matrix.hpp>
+#include <Stats.hpp>
 
 namespace algo {
 namespace johnson {
@@ -15,7 +16,8 @@ struct Graph: public GenericGraph<WeightedEdge>
 {
   Graph(size_t s): GenericGraph(s) {}
 
-  VerticeList bellmanFord(int s, const Graph& g) 
+  template<typename S>
+  VerticeList bellmanFord(int s, const Graph& g, S& stats) 
   {
     VerticeList distance(g.size, MAX_INT);
     distance[s] = 0;
@@ -26,7 +28,11 @@ struct Graph: public GenericGraph<WeightedEdge>
         }
         for(const auto& e: g.adjacency[u]) {
           int v = e.to;
-          distance[v] = std::min(distance[v], distance[u] + e.weight);
+          ALGO_COUNT(stats.edgeScans, 1);
+          if(distance[u] + e.weight < distance[v]) {
+            distance[v] = distance[u] + e.weight;
+            ALGO_COUNT(stats.relaxations, 1);
+          }
         }
       }
     }
@@ -34,7 +40,8 @@ struct Graph: public GenericGraph<WeightedEdge>
     return distance;
   }
 
-  auto dijkstra(int s, const Graph& g)
+  template<typename S>
+  auto dijkstra(int s, const Graph& g, S& stats)
   {
     Flags onHeap(g.size, false);
     Flags visited(g.size, false);
@@ -49,6 +56,7 @@ struct Graph: public GenericGraph<WeightedEdge>
     std::vector<int> heap;
     heap.push_back(s);
     onHeap[s] = true;
+    ALGO_COUNT(stats.heapPushes, 1);
 
     while(!heap.empty()) {
       int u = heap.front();
@@ -56,21 +64,26 @@ struct Graph: public GenericGraph<WeightedEdge>
       heap.pop_back();
       onHeap[u] = false;
       visited[u] = true;
+      ALGO_COUNT(stats.heapPops, 1);
 
       bool rebuildHeap = false;
       for(const auto& e: g.adjacency[u]) {
         const int v = e.to;
+        ALGO_COUNT(stats.edgeScans, 1);
         if(!visited[v]) {
           int aux = distance[u] + e.weight;
           if(aux < distance[v]) {
             parent[v] = u;
             distance[v] = aux;
+            ALGO_COUNT(stats.relaxations, 1);
             if(onHeap[v]) {
               rebuildHeap = true;
+              ALGO_COUNT(stats.decreaseKeys, 1);
             } else {
               heap.push_back(v);
               std::push_heap(heap.begin(), heap.end());
               onHeap[v] = true;
+              ALGO_COUNT(stats.heapPushes, 1);
             }
           }
         }
@@ -83,6 +96,21 @@ struct Graph: public GenericGraph<WeightedEdge>
   }
 
   auto johnson() 
+  {
+    ActiveStats stats;
+    return johnson(stats);
+  }
+
+  // Phases: bellman-ford, reweight, dijkstra (all n runs)
+  auto johnsonWithStats()
+  {
+    Stats stats;
+    auto result = johnson(stats);
+    return WithStats<decltype(result)>{std::move(result), std::move(stats)};
+  }
+
+  template<typename S>
+  std::pair<Matrix<int>, Matrix<int>> johnson(S& stats)
   {
     Graph g(size+1);
     std::copy(adjacency.begin(), adjacency.end(), g.adjacency.begin());
@@ -91,21 +119,29 @@ struct Graph: public GenericGraph<WeightedEdge>
       g.connect(s, i, 0);
     }
     
-    VerticeList d = bellmanFord(s, g);
+    VerticeList d;
+    {
+      ALGO_PHASE(stats, "bellman-ford");
+      d = bellmanFord(s, g, stats);
+    }
 
     // re-weight
-    for(int u=0; u<size; ++u) {
-      for(auto& e: g.adjacency[u]) {
-        const int v = e.to;
-        e.weight = e.weight + d[u] - d[v];
+    {
+      ALGO_PHASE(stats, "reweight");
+      for(size_t u=0; u<size; ++u) {
+        for(auto& e: g.adjacency[u]) {
+          const int v = e.to;
+          e.weight = e.weight + d[u] - d[v];
+        }
       }
     }
 
     Matrix<int> D(size, size, MAX_INT);
     Matrix<int> P(size, size, -1);
 
+    ALGO_PHASE(stats, "dijkstra");
     for(int u=0; u<size; ++u) {
-      auto dp = dijkstra(u, g);
+      auto dp = dijkstra(u, g, stats);
       for(int v=0; v<size; ++v) {
         D(u,v) = dp.first[v] + d[v] - d[u];
         P(u,v) = dp.second[v];
@@ -160,5 +196,33 @@ TEST(FloydWarshall, test1)
   EXPECT_THAT(p, testing::ElementsAre(4,3,2,1));
 }
 
+TEST(Johnson, stats)
+{
+  Graph g(5);
+  g.connect(0,1,3);
+  g.connect(0,2,8);
+  g.connect(0,4,-4);
+  g.connect(1,3,1);
+  g.connect(1,4,7);
+  g.connect(2,1,4);
+  g.connect(3,0,2);
+  g.connect(3,2,-5);
+  g.connect(4,3,6);
+
+  auto r = g.johnsonWithStats();
+  EXPECT_EQ(r.result.first(4,1), 5);
+  if(Stats::Enabled) {
+    // Every vertex reaches all others, each Dijkstra run scans all 9 edges
+    EXPECT_EQ(r.stats.heapPops, 5*5);
+    EXPECT_GE(r.stats.edgeScans, 5*9);
+    EXPECT_EQ(r.stats.phases.size(), 3);
+    EXPECT_EQ(r.stats.phases[0].name, "bellman-ford");
+    EXPECT_EQ(r.stats.phases[2].name, "dijkstra");
+  } else {
+    EXPECT_EQ(r.stats.edgeScans, 0);
+    EXPECT_TRUE(r.stats.phases.empty());
+  }
+}
+
 } // namespace johnson
 } // namespace algo
\ No newline at end of file
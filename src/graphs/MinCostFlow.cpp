@@ -0,0 +1,430 @@
+#include <limits>
+#include <queue>
+#include <random>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <Graph.hpp>
+
+namespace algo {
+namespace mcf {
+
+constexpr long long INF = std::numeric_limits<long long>::max();
+
+struct CostEdge
+{
+  int to;
+  int capacity;
+  int cost;
+};
+
+enum class Method
+{
+  SuccessiveShortestPath,
+  CostScaling
+};
+
+// Residual network kept as a single arc array grouped by tail vertice,
+// arc i and arcs[i].reverse form a forward/backward pair.
+struct ResidualNetwork
+{
+  struct Arc
+  {
+    int to;
+    int reverse;
+    int residual;
+    long long cost;
+  };
+
+  template<typename EL>
+  ResidualNetwork(const EL& adj): size(adj.size()), offset(size+1, 0)
+  {
+    for(int u=0; u<size; ++u) {
+      for(const auto& e: adj[u]) {
+        ++offset[u+1];
+        ++offset[e.to+1];
+      }
+    }
+    std::partial_sum(offset.begin(), offset.end(), offset.begin());
+    arcs.resize(offset[size]);
+    capacity.assign(offset[size], 0);
+
+    std::vector<int> pos(offset.begin(), offset.end()-1);
+    for(int u=0; u<size; ++u) {
+      for(const auto& e: adj[u]) {
+        const int i = pos[u]++;
+        const int j = pos[e.to]++;
+        arcs[i] = {e.to, j, e.capacity, e.cost};
+        arcs[j] = {u, i, 0, -static_cast<long long>(e.cost)};
+        capacity[i] = e.capacity;
+      }
+    }
+  }
+
+  void push(Arc& a, int df)
+  {
+    a.residual -= df;
+    arcs[a.reverse].residual += df;
+  }
+
+  // Total cost of the flow currently routed through original arcs
+  long long cost() const
+  {
+    long long c = 0;
+    for(size_t i=0; i<arcs.size(); ++i) {
+      c += (capacity[i] - arcs[i].residual) * (capacity[i] > 0 ? arcs[i].cost : 0);
+    }
+    return c;
+  }
+
+  int flow(int u) const
+  {
+    int f = 0;
+    for(int i=offset[u]; i<offset[u+1]; ++i) {
+      f += capacity[i] - arcs[i].residual;
+    }
+    return f;
+  }
+
+  const int size;
+  std::vector<int> offset;
+  std::vector<Arc> arcs;
+  std::vector<int> capacity; // Original capacities, 0 for backward arcs
+};
+
+using Result = std::pair<int, long long>; // flow value and its cost
+
+// Successive shortest paths: Dijkstra on reduced costs c(u,v) + p(u) - p(v) with Johnson
+// potentials. Initial potentials come from Bellman-Ford, so negative costs are allowed.
+struct ShortestPathSolver
+{
+  ShortestPathSolver(ResidualNetwork& n): net(n), potential(n.size, 0), distance(n.size), parent(n.size) {}
+
+  void bellmanFord(int s)
+  {
+    std::fill(potential.begin(), potential.end(), INF);
+    potential[s] = 0;
+    for(int i=0; i<net.size; ++i) {
+      bool relaxed = false;
+      for(int u=0; u<net.size; ++u) {
+        if(potential[u] == INF) {
+          continue;
+        }
+        for(int a=net.offset[u]; a<net.offset[u+1]; ++a) {
+          const auto& arc = net.arcs[a];
+          if(arc.residual > 0 && potential[u] + arc.cost < potential[arc.to]) {
+            potential[arc.to] = potential[u] + arc.cost;
+            relaxed = true;
+          }
+        }
+      }
+      if(!relaxed) {
+        return;
+      }
+    }
+    throw std::runtime_error("Negative cost cycle");
+  }
+
+  bool dijkstra(int s, int t)
+  {
+    using Item = std::pair<long long, int>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> heap;
+    std::fill(distance.begin(), distance.end(), INF);
+    distance[s] = 0;
+    heap.push({0, s});
+    while(!heap.empty()) {
+      const auto [d, u] = heap.top();
+      heap.pop();
+      if(d > distance[u]) {
+        continue;
+      }
+      for(int a=net.offset[u]; a<net.offset[u+1]; ++a) {
+        const auto& arc = net.arcs[a];
+        if(arc.residual > 0) {
+          const long long aux = d + arc.cost + potential[u] - potential[arc.to];
+          if(aux < distance[arc.to]) {
+            distance[arc.to] = aux;
+            parent[arc.to] = a;
+            heap.push({aux, arc.to});
+          }
+        }
+      }
+    }
+    return distance[t] != INF;
+  }
+
+  Result solve(int s, int t)
+  {
+    bellmanFord(s);
+    Result result(0, 0);
+    while(dijkstra(s, t)) {
+      for(int v=0; v<net.size; ++v) {
+        if(distance[v] != INF) {
+          potential[v] += distance[v];
+        }
+      }
+      int volume = std::numeric_limits<int>::max();
+      for(int v=t; v!=s; v=net.arcs[net.arcs[parent[v]].reverse].to) {
+        volume = std::min(volume, net.arcs[parent[v]].residual);
+      }
+      for(int v=t; v!=s; v=net.arcs[net.arcs[parent[v]].reverse].to) {
+        net.push(net.arcs[parent[v]], volume);
+      }
+      result.first += volume;
+      result.second += volume * (potential[t] - potential[s]);
+    }
+    return result;
+  }
+
+  ResidualNetwork& net;
+  std::vector<long long> potential;
+  std::vector<long long> distance;
+  std::vector<int> parent;
+};
+
+// Goldberg-Tarjan cost scaling. Max flow is turned into a min cost circulation by
+// an extra sink -> source arc whose cost is lower than any path can compensate.
+struct CostScalingSolver
+{
+  CostScalingSolver(ResidualNetwork& n, int alpha = 8):
+    net(n), alpha(alpha), potential(n.size, 0), excess(n.size, 0), current(n.size)
+  {}
+
+  long long reducedCost(int u, const ResidualNetwork::Arc& a) const
+  {
+    return a.cost + potential[u] - potential[a.to];
+  }
+
+  void push(int u, ResidualNetwork::Arc& a, int df)
+  {
+    net.push(a, df);
+    excess[u] -= df;
+    excess[a.to] += df;
+  }
+
+  void relabel(int u, long long eps)
+  {
+    long long p = -INF;
+    for(int a=net.offset[u]; a<net.offset[u+1]; ++a) {
+      const auto& arc = net.arcs[a];
+      if(arc.residual > 0) {
+        p = std::max(p, potential[arc.to] - arc.cost);
+      }
+    }
+    potential[u] = p - eps;
+  }
+
+  void refine(long long eps)
+  {
+    std::queue<int> active;
+    for(int u=0; u<net.size; ++u) {
+      for(int a=net.offset[u]; a<net.offset[u+1]; ++a) {
+        auto& arc = net.arcs[a];
+        if(arc.residual > 0 && reducedCost(u, arc) < 0) {
+          push(u, arc, arc.residual);
+        }
+      }
+    }
+    for(int u=0; u<net.size; ++u) {
+      current[u] = net.offset[u];
+      if(excess[u] > 0) {
+        active.push(u);
+      }
+    }
+
+    while(!active.empty()) {
+      const int u = active.front();
+      active.pop();
+      while(excess[u] > 0) {
+        if(current[u] == net.offset[u+1]) {
+          relabel(u, eps);
+          current[u] = net.offset[u];
+          continue;
+        }
+        auto& arc = net.arcs[current[u]];
+        if(arc.residual > 0 && reducedCost(u, arc) < 0) {
+          const bool wasActive = excess[arc.to] > 0;
+          push(u, arc, static_cast<int>(std::min<long long>(excess[u], arc.residual)));
+          if(!wasActive && excess[arc.to] > 0) {
+            active.push(arc.to);
+          }
+        } else {
+          ++current[u];
+        }
+      }
+    }
+  }
+
+  void solve()
+  {
+    // Scale costs by n + 1, so that 1-optimal circulation is optimal for the original costs
+    const long long scale = net.size + 1;
+    long long eps = 1;
+    for(auto& arc: net.arcs) {
+      arc.cost *= scale;
+      eps = std::max(eps, std::abs(arc.cost));
+    }
+    do {
+      eps = std::max(1LL, eps / alpha);
+      refine(eps);
+    } while(eps > 1);
+    for(auto& arc: net.arcs) {
+      arc.cost /= scale;
+    }
+  }
+
+  ResidualNetwork& net;
+  const int alpha;
+  std::vector<long long> potential;
+  std::vector<long long> excess;
+  std::vector<int> current;
+};
+
+struct Graph: public GenericGraph<CostEdge>
+{
+  Graph(size_t s): GenericGraph(s) {}
+
+  Result minCostMaxFlow(int source, int sink, Method method = Method::SuccessiveShortestPath)
+  {
+    if(method == Method::SuccessiveShortestPath) {
+      ResidualNetwork net(adjacency);
+      ShortestPathSolver solver(net);
+      return solver.solve(source, sink);
+    }
+
+    long long maxCost = 1;
+    long long outCapacity = 0;
+    for(size_t u=0; u<size; ++u) {
+      for(const auto& e: adjacency[u]) {
+        maxCost = std::max(maxCost, static_cast<long long>(std::abs(e.cost)));
+      }
+    }
+    for(const auto& e: adjacency[source]) {
+      outCapacity += e.capacity;
+    }
+
+    // Costs are scaled by n + 1 and potentials reach about 3n times the largest scaled
+    // cost, successive shortest paths take over when that would overflow
+    const long long n = size;
+    long long backCost, bound;
+    if(__builtin_mul_overflow(2*n, maxCost, &backCost) || __builtin_mul_overflow(backCost + 1, 3*(n+1)*(n+1), &bound)) {
+      return minCostMaxFlow(source, sink, Method::SuccessiveShortestPath);
+    }
+    backCost = -(backCost + 1);
+
+    // Flow values are int, so is the capacity of the extra arc
+    struct WideEdge
+    {
+      int to;
+      int capacity;
+      long long cost;
+    };
+    std::vector<std::vector<WideEdge>> adj(size);
+    for(size_t u=0; u<size; ++u) {
+      for(const auto& e: adjacency[u]) {
+        adj[u].push_back({e.to, e.capacity, e.cost});
+      }
+    }
+    adj[sink].push_back({source, static_cast<int>(std::min<long long>(outCapacity, std::numeric_limits<int>::max())), backCost});
+    ResidualNetwork net(adj);
+    int back = net.offset[sink];
+    while(net.capacity[back] == 0 || net.arcs[back].cost != backCost) {
+      ++back;
+    }
+
+    CostScalingSolver solver(net);
+    solver.solve();
+
+    const int flow = net.capacity[back] - net.arcs[back].residual;
+    return Result(flow, net.cost() - flow*backCost);
+  }
+};
+
+TEST(MinCostFlow, test1)
+{
+  Graph g(4);
+  g.connect(0,1,2,1);
+  g.connect(0,2,1,2);
+  g.connect(1,2,1,1);
+  g.connect(1,3,1,3);
+  g.connect(2,3,2,1);
+
+  EXPECT_THAT(g.minCostMaxFlow(0,3), testing::Eq(Result(3,10)));
+  EXPECT_THAT(g.minCostMaxFlow(0,3,Method::CostScaling), testing::Eq(Result(3,10)));
+}
+
+TEST(MinCostFlow, assignment)
+{
+  // Same costs as Hungarian.test3, rows 1..3, columns 4..6
+  const int costs[3][3] = {{1,1,1}, {9,1,8}, {1,6,4}};
+  Graph g(8);
+  for(int i=0; i<3; ++i) {
+    g.connect(0, 1+i, 1, 0);
+    g.connect(4+i, 7, 1, 0);
+    for(int j=0; j<3; ++j) {
+      g.connect(1+i, 4+j, 1, costs[i][j]);
+    }
+  }
+  EXPECT_THAT(g.minCostMaxFlow(0,7), testing::Eq(Result(3,3)));
+  EXPECT_THAT(g.minCostMaxFlow(0,7,Method::CostScaling), testing::Eq(Result(3,3)));
+}
+
+TEST(MinCostFlow, negativeCosts)
+{
+  Graph g(4);
+  g.connect(0,1,2,-2);
+  g.connect(0,2,2,1);
+  g.connect(1,3,1,-1);
+  g.connect(2,3,3,2);
+  g.connect(1,2,2,0);
+
+  // Every arc is forced: 2*(-2) + 2*1 + 1*(-1) + 1*0 + 3*2
+  EXPECT_THAT(g.minCostMaxFlow(0,3), testing::Eq(Result(4,3)));
+  EXPECT_THAT(g.minCostMaxFlow(0,3,Method::CostScaling), testing::Eq(Result(4,3)));
+}
+
+TEST(MinCostFlow, largeCosts)
+{
+  // The sink -> source arc cost no longer fits int
+  const int big = 2000000000;
+  Graph g(4);
+  g.connect(0,1,2,big);
+  g.connect(0,2,1,big - 1);
+  g.connect(1,3,1,big);
+  g.connect(2,3,2,1);
+  g.connect(1,2,1,0);
+  const Result expected(3, 4LL*big + 1);
+  EXPECT_THAT(g.minCostMaxFlow(0,3), testing::Eq(expected));
+  EXPECT_THAT(g.minCostMaxFlow(0,3,Method::CostScaling), testing::Eq(expected));
+
+  // Scaled potentials would overflow long long, solved by successive shortest paths
+  Graph h(20000);
+  h.connect(0,1,3,big);
+  h.connect(1,19999,2,-big);
+  h.connect(0,19999,1,7);
+  EXPECT_THAT(h.minCostMaxFlow(0,19999,Method::CostScaling), testing::Eq(Result(3,7)));
+}
+
+TEST(MinCostFlow, random)
+{
+  std::mt19937 gen(7);
+  for(int test=0; test<20; ++test) {
+    const int n = 12;
+    std::uniform_int_distribution<int> node(0, n-1);
+    std::uniform_int_distribution<int> capacity(1, 10);
+    std::uniform_int_distribution<int> cost(0, 20);
+    Graph g(n);
+    for(int i=0; i<40; ++i) {
+      const int u = node(gen);
+      const int v = node(gen);
+      if(u != v) {
+        g.connect(u, v, capacity(gen), cost(gen));
+      }
+    }
+    EXPECT_THAT(g.minCostMaxFlow(0, n-1, Method::CostScaling), testing::Eq(g.minCostMaxFlow(0, n-1)));
+  }
+}
+
+} // namespace mcf
+} // namespace algo
@@ -4,6 +4,8 @@
 #include <gmock/gmock.h>
 
 #include <Graph.hpp>
+#include <GraphReader.hpp>
+#include <TestFiles.hpp>
 
 namespace algo {
 namespace mst {
@@ -111,5 +113,13 @@ TEST(MinimumSpanningTree, Kruskal1)
   EXPECT_EQ(g.kruskal(), 9);
 }
 
+TEST(MinimumSpanningTree, metis)
+{
+  const test::TempFile file("mst.graph", test::METIS_EXAMPLE);
+  auto g = readMetis<Graph>(file.path());
+  EXPECT_EQ(g.prim(), 12);
+  EXPECT_EQ(g.kruskal(), 12);
+}
+
 } // namespace mst
 } // namespace algo
\ No newline at end of file
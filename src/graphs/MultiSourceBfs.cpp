@@ -0,0 +1,99 @@
+#include <chrono>
+#include <random>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <GraphGenerator.hpp>
+#include <MultiSourceBfs.hpp>
+
+namespace algo {
+namespace {
+
+using Graph = GenericGraph<>;
+
+std::vector<int> depths(Graph& g, int source)
+{
+  struct Depth: public Graph::TraversalState
+  {
+    Depth(size_t n): Graph::TraversalState(n), depth(n, -1) {}
+    void processEdge(int u, const GenericEdge& e) override
+    {
+      if(depth[e.to] < 0) {
+        depth[e.to] = depth[u] + 1;
+      }
+    }
+    std::vector<int> depth;
+  };
+  Depth d(g.vertices());
+  d.depth[source] = 0;
+  g.bfsImpl(source, d);
+  return d.depth;
+}
+
+std::vector<int> randomSources(size_t count, size_t n, unsigned seed)
+{
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> node(0, n-1);
+  std::vector<int> sources(count);
+  for(auto& s: sources) {
+    s = node(gen);
+  }
+  return sources;
+}
+
+} // namespace
+
+TEST(MultiSourceBfs, sourceSet)
+{
+  SourceSet<2> a, b;
+  a.set(3);
+  a.set(70);
+  b.set(70);
+  EXPECT_TRUE(a.test(70));
+  EXPECT_FALSE(a.test(69));
+  std::vector<size_t> items;
+  a.forEach([&](size_t i) { items.push_back(i); });
+  EXPECT_THAT(items, testing::ElementsAre(3, 70));
+  a.remove(b);
+  EXPECT_FALSE(a.test(70));
+  a.remove(a);
+  EXPECT_FALSE(a.any());
+}
+
+TEST(MultiSourceBfs, distances)
+{
+  Graph g = generate::rmat(10, 6, 2).graph<Graph>();
+  // 150 sources, duplicates included: three batches of 64, two of 128, one of 512
+  auto sources = randomSources(150, g.vertices(), 3);
+  sources[7] = sources[3];
+  std::vector<std::vector<int>> expected;
+  for(int s: sources) {
+    expected.push_back(depths(g, s));
+  }
+  EXPECT_EQ(hopDistances<1>(g, sources, 2), expected);
+  EXPECT_EQ(hopDistances<2>(g, sources, 1), expected);
+  EXPECT_EQ(hopDistances<8>(g, sources), expected);
+
+  EXPECT_THROW(multiSourceBfs<1>(g, std::vector<int>(65, 0), [](int, const SourceSet<1>&, int) {}), std::invalid_argument);
+}
+
+TEST(MultiSourceBfs, DISABLED_benchmark)
+{
+  Graph g = generate::rmat(16, 16, 1).graph<Graph>();
+  const auto sources = randomSources(512, g.vertices(), 1);
+  auto start = std::chrono::steady_clock::now();
+  Graph::TraversalState state(g.vertices());
+  for(int s: sources) {
+    state.reset();
+    g.bfsImpl(s, state);
+  }
+  const double single = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  start = std::chrono::steady_clock::now();
+  size_t reached = 0;
+  multiSourceBfs<8>(g, sources, [&](int, const SourceSet<8>&, int) { ++reached; });
+  const double batched = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  std::cout << "512 x bfsImpl: " << single << "ms, MS-BFS: " << batched << "ms" << std::endl;
+}
+
+} // namespace algo
@@ -1,10 +1,18 @@
-#include <queue> 
+#include <atomic>
+#include <chrono>
+#include <queue>
 #include <list>
+#include <random>
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
 #include <Graph.hpp>
+#include <GraphGenerator.hpp>
+#include <GraphReader.hpp>
+#include <Parallel.hpp>
+#include <Stats.hpp>
+#include <TestFiles.hpp>
 
 namespace algo {
 namespace push_relabel {
@@ -16,6 +24,7 @@ struct ResidualEdge
   int to;
   int capacity;
   int flow = 0;
+  int reverse = -1; // Index of the reverse edge in adjacency[to]
 };
 
 struct CapacityEdge
@@ -30,58 +39,65 @@ struct Vertice
   int excess;
 };
 
+enum class Method
+{
+  Generic,
+  RelabelToFront,
+  HighestLabel,
+  Parallel
+};
+
 struct ResidualFlowGraph: public GenericGraph<ResidualEdge>
 {
   template<typename EL>
-  ResidualFlowGraph(const EL& adj, int s, int t): 
+  ResidualFlowGraph(const EL& adj, int s, int t):
     GenericGraph(adj.size()), source(s), sink(t)
   {
     for(int u=0; u<size; ++u) {
       for(const auto& e: adj[u]) {
-        connect(u, e.to, e.capacity);
-        connect(e.to, u, 0);
+        const int ru = adjacency[e.to].size() + (u == e.to ? 1 : 0);
+        const int rv = adjacency[u].size();
+        connect(u, e.to, e.capacity, 0, ru);
+        connect(e.to, u, 0, 0, rv);
       }
-    } 
-    
+    }
+
     vertices.assign(size, {0,0});
     vertices[source].height = size;
     for(auto& e: adjacency[source]) {
       const int capacity = e.capacity;
-      e.flow = capacity;
+      e.flow += capacity;
       e.capacity = 0;
-      auto& reverse = edge(e.to, source);
-      reverse.capacity = capacity;
-      vertices[e.to].excess = capacity;
+      auto& r = reverse(e);
+      r.flow -= capacity;
+      r.capacity += capacity;
+      vertices[e.to].excess += capacity;
       vertices[source].excess -= capacity;
     }
   }
 
-  ResidualEdge& edge(int u, int v) 
+  ResidualEdge& reverse(const ResidualEdge& e)
   {
-    for(ResidualEdge& e: adjacency[u]) {
-      if(e.to == v) {
-        return e;
-      }
-    }
-    throw std::runtime_error("Edge not found");
+    return adjacency[e.to][e.reverse];
   }
 
-  bool push(int i, ResidualEdge& e) 
+  bool push(int i, ResidualEdge& e)
   {
     Vertice& u = vertices[i];
     Vertice& v = vertices[e.to];
+    ALGO_COUNT(stats.edgeScans, 1);
     if((e.capacity > 0) && (u.height == v.height + 1)) {
+      ALGO_COUNT(stats.pushes, 1);
       int df = std::min(u.excess, e.capacity);
       e.flow += df;
       e.capacity -= df;
-      auto& reverse = edge(e.to, i);
-      reverse.flow -= df;
-      reverse.capacity += df;
+      auto& r = reverse(e);
+      r.flow -= df;
+      r.capacity += df;
       u.excess -= df;
       v.excess += df;
-      // std::cout << "Pushing " << df << " from " << i << " to " << e.to << std::endl;
       return true;
-    } 
+    }
     return false;
   }
 
@@ -103,24 +119,24 @@ struct ResidualFlowGraph: public GenericGraph<ResidualEdge>
     return false;
   }
 
-  bool relabel(int i) 
+  bool relabel(int i)
   {
     Vertice& u = vertices[i];
     if(u.excess > 0) {
-      // std::cout << i << " has excess " << u.excess << std::endl;
       int minAdjHeight = MAX_INT;
+      ALGO_COUNT(stats.edgeScans, adjacency[i].size());
       for(const auto& e: adjacency[i]) {
-        // std::cout << "Edge to " << e.to << " has capacity " <<  e.capacity << std::endl;
-        if(e.capacity > e.flow) {
+        if(e.capacity > 0) {
           minAdjHeight = std::min(minAdjHeight, vertices[e.to].height);
         }
       }
       if(minAdjHeight < MAX_INT && minAdjHeight >= u.height) {
         u.height = minAdjHeight + 1;
-        // std::cout << "Relabeling " << i << " to " << u.height << std::endl;
+        ALGO_COUNT(stats.relabels, 1);
         return true;
       }
     }
+    return false;
   }
 
   bool relabel()
@@ -135,7 +151,7 @@ struct ResidualFlowGraph: public GenericGraph<ResidualEdge>
     return false;
   }
 
-  void discharge(int i) 
+  void discharge(int i)
   {
     Vertice& u = vertices[i];
     auto eit = adjacency[i].begin();
@@ -149,7 +165,7 @@ struct ResidualFlowGraph: public GenericGraph<ResidualEdge>
     }
   }
 
-  void relabelToFront() 
+  void relabelToFront()
   {
     std::list<int> list;
     for(int i=0; i<size; ++i) {
@@ -172,6 +188,172 @@ struct ResidualFlowGraph: public GenericGraph<ResidualEdge>
     }
   }
 
+  // Exact distance labels computed by reverse BFS in the residual graph: distance to sink
+  // for vertices which can still reach it, size + distance to source for the rest.
+  void globalRelabel(VerticeList& count)
+  {
+    ALGO_PHASE(stats, "global relabel");
+    const int unreachable = 2*size;
+    for(auto& v: vertices) {
+      v.height = unreachable;
+    }
+    count.assign(2*size+1, 0);
+
+    std::queue<int> queue;
+    auto bfs = [&](int root, int base) {
+      vertices[root].height = base;
+      queue.push(root);
+      while(!queue.empty()) {
+        const int v = queue.front();
+        queue.pop();
+        ALGO_COUNT(stats.edgeScans, adjacency[v].size());
+        for(const ResidualEdge& e: adjacency[v]) {
+          // Residual capacity of edge e.to -> v is kept by the reverse of e
+          if(vertices[e.to].height == unreachable && reverse(e).capacity > 0) {
+            vertices[e.to].height = vertices[v].height + 1;
+            queue.push(e.to);
+          }
+        }
+      }
+    };
+    bfs(sink, 0);
+    bfs(source, size);
+
+    for(const auto& v: vertices) {
+      ++count[v.height];
+    }
+  }
+
+  // Highest-label push-relabel with current arcs, gap heuristic and periodic global
+  // relabeling. Runs both phases, so that edge flows form a valid maximum flow.
+  void highestLabel()
+  {
+    const int n = size;
+    const int unreachable = 2*n;
+    VerticeList count;
+    std::vector<size_t> current(size, 0);
+    Flags queued(size, false);
+    std::vector<VerticeList> buckets(2*size);
+    int highest = 0;
+
+    auto activate = [&](int v) {
+      if(!queued[v] && v != source && v != sink && vertices[v].height < unreachable) {
+        queued[v] = true;
+        buckets[vertices[v].height].push_back(v);
+        highest = std::max(highest, vertices[v].height);
+      }
+    };
+
+    auto rebuild = [&]() {
+      globalRelabel(count);
+      for(auto& b: buckets) {
+        b.clear();
+      }
+      queued.assign(size, false);
+      current.assign(size, 0);
+      highest = 0;
+      for(size_t v=0; v<size; ++v) {
+        if(vertices[v].excess > 0) {
+          activate(v);
+        }
+      }
+    };
+
+    // Relabel v, returns false if v can no longer reach neither sink nor source
+    auto relabel = [&](int v) {
+      Vertice& u = vertices[v];
+      const int old = u.height;
+      int minAdjHeight = unreachable;
+      ALGO_COUNT(stats.edgeScans, adjacency[v].size());
+      ALGO_COUNT(stats.relabels, 1);
+      for(const auto& e: adjacency[v]) {
+        if(e.capacity > 0) {
+          minAdjHeight = std::min(minAdjHeight, vertices[e.to].height);
+        }
+      }
+      u.height = std::min(minAdjHeight + 1, unreachable);
+      --count[old];
+      ++count[u.height];
+      current[v] = 0;
+
+      if(count[old] == 0 && old < n) {
+        // Gap: vertices above old height can no longer reach the sink
+        for(size_t w=0; w<size; ++w) {
+          Vertice& x = vertices[w];
+          if(x.height > old && x.height < n) {
+            --count[x.height];
+            x.height = n + 1;
+            ++count[x.height];
+            current[w] = 0;
+            if(queued[w]) {
+              buckets[x.height].push_back(w);
+              highest = std::max(highest, x.height);
+            }
+          }
+        }
+      }
+      return u.height < unreachable;
+    };
+
+    const long long globalRelabelWork = 6*static_cast<long long>(size) + edgeCount();
+    long long work = 0;
+
+    rebuild();
+    while(highest >= 0) {
+      if(buckets[highest].empty()) {
+        --highest;
+        continue;
+      }
+      const int v = buckets[highest].back();
+      buckets[highest].pop_back();
+      if(vertices[v].height != highest) {
+        // Stale entry left behind by the gap heuristic
+        continue;
+      }
+      queued[v] = false;
+
+      Vertice& u = vertices[v];
+      auto& edges = adjacency[v];
+      while(u.excess > 0) {
+        if(current[v] == edges.size()) {
+          work += edges.size() + 12;
+          if(!relabel(v)) {
+            break;
+          }
+          continue;
+        }
+        ResidualEdge& e = edges[current[v]];
+        if(e.capacity > 0 && u.height == vertices[e.to].height + 1) {
+          const bool wasActive = vertices[e.to].excess > 0;
+          push(v, e);
+          if(!wasActive) {
+            activate(e.to);
+          }
+        } else {
+          ALGO_COUNT(stats.edgeScans, 1);
+          ++current[v];
+        }
+      }
+      if(u.excess > 0) {
+        activate(v);
+      }
+
+      if(work > globalRelabelWork) {
+        work = 0;
+        rebuild();
+      }
+    }
+  }
+
+  size_t edgeCount() const
+  {
+    size_t m = 0;
+    for(const auto& edges: adjacency) {
+      m += edges.size();
+    }
+    return m;
+  }
+
   int flow(int source) const
   {
     int f = 0;
@@ -184,24 +366,276 @@ struct ResidualFlowGraph: public GenericGraph<ResidualEdge>
   const int source;
   const int sink;
   std::vector<Vertice> vertices;
+  ActiveStats stats;
+};
+
+// Lock-free push-relabel after Hong and He: every vertice is owned by a single thread,
+// which is the only one to decrease its excess, its outgoing residuals and to lift it.
+// Other threads only increase them, so pushes need nothing more than atomic add/sub.
+// Work proceeds in rounds separated by a parallel global relabel.
+struct ConcurrentFlowGraph
+{
+  template<typename EL>
+  ConcurrentFlowGraph(const EL& adj, int s, int t, unsigned threads):
+    size(adj.size()), source(s), sink(t), threads(std::max(1u, threads)),
+    offset(size+1, 0), height(size), excess(size), barrier(this->threads), next(this->threads)
+  {
+    for(int u=0; u<size; ++u) {
+      for(const auto& e: adj[u]) {
+        ++offset[u+1];
+        ++offset[e.to+1];
+      }
+    }
+    std::partial_sum(offset.begin(), offset.end(), offset.begin());
+
+    const int m = offset[size];
+    to.resize(m);
+    reverse.resize(m);
+    residual = std::vector<std::atomic<int>>(m);
+    VerticeList pos(offset.begin(), offset.end()-1);
+    for(int u=0; u<size; ++u) {
+      for(const auto& e: adj[u]) {
+        const int i = pos[u]++;
+        const int j = pos[e.to]++;
+        to[i] = e.to;
+        to[j] = u;
+        reverse[i] = j;
+        reverse[j] = i;
+        residual[i].store(e.capacity, std::memory_order_relaxed);
+        residual[j].store(0, std::memory_order_relaxed);
+      }
+    }
+
+    for(int u=0; u<size; ++u) {
+      excess[u].store(0, std::memory_order_relaxed);
+    }
+    for(int i=offset[source]; i<offset[source+1]; ++i) {
+      const int c = residual[i].load(std::memory_order_relaxed);
+      residual[i].store(0, std::memory_order_relaxed);
+      residual[reverse[i]].fetch_add(c, std::memory_order_relaxed);
+      excess[to[i]].fetch_add(c, std::memory_order_relaxed);
+      excess[source].fetch_sub(c, std::memory_order_relaxed);
+    }
+  }
+
+  int maxFlow()
+  {
+    parallelRun(threads, [this](unsigned id) {
+      const long long budget = (6*static_cast<long long>(size) + offset[size]) / threads + 1;
+      while(true) {
+        globalRelabel(id);
+        work(id, budget);
+        barrier.wait();
+        if(id == 0) {
+          done = !anyActive();
+        }
+        barrier.wait();
+        if(done) {
+          break;
+        }
+      }
+    });
+    return excess[sink].load();
+  }
+
+private:
+  using VerticeList = std::vector<int>;
+
+  int unreachable() const
+  {
+    return 2*size;
+  }
+
+  bool anyActive() const
+  {
+    for(int u=0; u<size; ++u) {
+      if(u != source && u != sink && excess[u].load(std::memory_order_relaxed) > 0 &&
+          height[u].load(std::memory_order_relaxed) < unreachable()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Discharges owned vertices until none of them is active or the round budget is spent
+  void work(unsigned id, long long budget)
+  {
+    long long ops = 0;
+    bool active = true;
+    while(active && ops < budget) {
+      active = false;
+      for(int u=id; u<size; u+=threads) {
+        if(u == source || u == sink) {
+          continue;
+        }
+        while(excess[u].load(std::memory_order_acquire) > 0 && height[u].load(std::memory_order_relaxed) < unreachable()) {
+          active = true;
+          ++ops;
+          const int e = excess[u].load(std::memory_order_acquire);
+          int lowest = -1;
+          int minHeight = unreachable();
+          for(int i=offset[u]; i<offset[u+1]; ++i) {
+            if(residual[i].load(std::memory_order_acquire) > 0) {
+              const int h = height[to[i]].load(std::memory_order_relaxed);
+              if(h < minHeight) {
+                minHeight = h;
+                lowest = i;
+              }
+            }
+          }
+          if(lowest < 0) {
+            break;
+          }
+          if(height[u].load(std::memory_order_relaxed) > minHeight) {
+            const int d = std::min(e, residual[lowest].load(std::memory_order_acquire));
+            residual[lowest].fetch_sub(d, std::memory_order_acq_rel);
+            residual[reverse[lowest]].fetch_add(d, std::memory_order_acq_rel);
+            excess[u].fetch_sub(d, std::memory_order_acq_rel);
+            excess[to[lowest]].fetch_add(d, std::memory_order_acq_rel);
+          } else {
+            height[u].store(minHeight + 1, std::memory_order_relaxed);
+          }
+        }
+      }
+    }
+  }
+
+  // Level synchronous reverse BFS from sink, then from source, vertices are claimed by CAS
+  void globalRelabel(unsigned id)
+  {
+    for(int u=id; u<size; u+=threads) {
+      height[u].store(unreachable(), std::memory_order_relaxed);
+    }
+    barrier.wait();
+    if(id == 0) {
+      height[source].store(size);
+      height[sink].store(0);
+    }
+
+    for(int root: {sink, source}) {
+      barrier.wait();
+      if(id == 0) {
+        frontier.assign(1, root);
+      }
+      barrier.wait();
+      while(!frontier.empty()) {
+        auto& local = next[id];
+        local.clear();
+        for(size_t k=id; k<frontier.size(); k+=threads) {
+          const int v = frontier[k];
+          const int h = height[v].load(std::memory_order_relaxed) + 1;
+          for(int i=offset[v]; i<offset[v+1]; ++i) {
+            // Residual capacity of to[i] -> v is kept by the reverse edge
+            if(residual[reverse[i]].load(std::memory_order_relaxed) > 0) {
+              int expected = unreachable();
+              if(height[to[i]].compare_exchange_strong(expected, h, std::memory_order_relaxed)) {
+                local.push_back(to[i]);
+              }
+            }
+          }
+        }
+        barrier.wait();
+        if(id == 0) {
+          frontier.clear();
+          for(const auto& n: next) {
+            frontier.insert(frontier.end(), n.begin(), n.end());
+          }
+        }
+        barrier.wait();
+      }
+    }
+  }
+
+  const int size;
+  const int source;
+  const int sink;
+  const unsigned threads;
+
+  VerticeList offset;
+  VerticeList to;
+  VerticeList reverse;
+  std::vector<std::atomic<int>> residual;
+  std::vector<std::atomic<int>> height;
+  std::vector<std::atomic<int>> excess;
+
+  Barrier barrier;
+  bool done = false;
+  VerticeList frontier;
+  std::vector<VerticeList> next;
 };
 
 struct Graph: public GenericGraph<CapacityEdge>
 {
   Graph(size_t s): GenericGraph(s) {}
 
-  int maxFlow(int source, int sink, bool toFront = true)
+  int maxFlow(int source, int sink, Method method = Method::HighestLabel, unsigned threads = hardwareThreads())
   {
-    ResidualFlowGraph rg(adjacency, source, sink);
-    if(toFront) {
-      rg.relabelToFront();
-    } else {
-      while(rg.push() || rg.relabel());
+    ActiveStats stats;
+    return maxFlow(source, sink, method, threads, stats);
+  }
+
+  // Phases: build, solve and for highest label global relabel (part of solve). The
+  // parallel method reports phases only.
+  WithStats<int> maxFlowWithStats(int source, int sink, Method method = Method::HighestLabel, unsigned threads = hardwareThreads())
+  {
+    WithStats<int> r;
+    r.result = maxFlow(source, sink, method, threads, r.stats);
+    return r;
+  }
+
+private:
+  template<typename S>
+  int maxFlow(int source, int sink, Method method, unsigned threads, S& stats)
+  {
+    int flow = 0;
+    if(method == Method::Parallel) {
+      auto cg = [&]() {
+        ALGO_PHASE(stats, "build");
+        return ConcurrentFlowGraph(adjacency, source, sink, threads);
+      }();
+      {
+        ALGO_PHASE(stats, "solve");
+        flow = cg.maxFlow();
+      }
+      return flow;
     }
-    return rg.flow(source);
+    auto rg = [&]() {
+      ALGO_PHASE(stats, "build");
+      return ResidualFlowGraph(adjacency, source, sink);
+    }();
+    flow = solve(rg, method);
+#if ALGO_STATS
+    stats += rg.stats;
+#endif
+    return flow;
+  }
+
+  int solve(ResidualFlowGraph& rg, Method method)
+  {
+    ALGO_PHASE(rg.stats, "solve");
+    switch(method) {
+      case Method::HighestLabel:
+        rg.highestLabel();
+        break;
+      case Method::RelabelToFront:
+        rg.relabelToFront();
+        break;
+      case Method::Generic:
+      default:
+        while(rg.push() || rg.relabel());
+        break;
+    }
+    return rg.flow(rg.source);
   }
 };
 
+// Random layered network in the spirit of DIMACS generators (e.g. AK, Washington),
+// source is the first and sink the last vertice.
+Graph layeredNetwork(int layers, int width, int degree, int maxCapacity, unsigned seed)
+{
+  return generate::layeredFlow(layers, width, degree, maxCapacity, seed).graph<Graph>();
+}
+
 TEST(PushRelabel, test1)
 {
   Graph g(6);
@@ -215,8 +649,9 @@ TEST(PushRelabel, test1)
   g.connect(4,3,7);
   g.connect(4,5,4);
 
-  EXPECT_THAT(g.maxFlow(0,5, true), testing::Eq(23));
-  EXPECT_THAT(g.maxFlow(0,5, false), testing::Eq(23));
+  EXPECT_THAT(g.maxFlow(0,5, Method::RelabelToFront), testing::Eq(23));
+  EXPECT_THAT(g.maxFlow(0,5, Method::Generic), testing::Eq(23));
+  EXPECT_THAT(g.maxFlow(0,5, Method::HighestLabel), testing::Eq(23));
 }
 
 TEST(PushRelabel, test2)
@@ -230,9 +665,117 @@ TEST(PushRelabel, test2)
   g.connect(3,1,7);
   g.connect(3,4,10);
 
-  EXPECT_THAT(g.maxFlow(0,4,true), testing::Eq(20));
-  EXPECT_THAT(g.maxFlow(0,4,false), testing::Eq(20));
+  EXPECT_THAT(g.maxFlow(0,4, Method::RelabelToFront), testing::Eq(20));
+  EXPECT_THAT(g.maxFlow(0,4, Method::Generic), testing::Eq(20));
+  EXPECT_THAT(g.maxFlow(0,4, Method::HighestLabel), testing::Eq(20));
+}
+
+TEST(PushRelabel, stats)
+{
+  Graph g = layeredNetwork(6, 10, 3, 20, 4);
+  const int sink = g.vertices()-1;
+  for(Method method: {Method::HighestLabel, Method::RelabelToFront, Method::Generic}) {
+    auto r = g.maxFlowWithStats(0, sink, method);
+    EXPECT_EQ(r.result, g.maxFlow(0, sink, method));
+    if(Stats::Enabled) {
+      EXPECT_GT(r.stats.pushes, 0);
+      EXPECT_GT(r.stats.relabels, 0);
+      EXPECT_GE(r.stats.edgeScans, r.stats.pushes);
+      EXPECT_GT(r.stats.phase("solve"), 0);
+      EXPECT_EQ(r.stats.phase("global relabel") > 0, method == Method::HighestLabel);
+    } else {
+      EXPECT_EQ(r.stats.pushes + r.stats.relabels + r.stats.edgeScans, 0);
+      EXPECT_TRUE(r.stats.phases.empty());
+    }
+  }
+}
+
+TEST(PushRelabel, dimacs)
+{
+  const test::TempFile file("push_relabel.max", test::DIMACS_MAX_FLOW);
+  auto dimacs = readDimacs<Graph>(file.path(), 3);
+  EXPECT_EQ(dimacs.source, 0);
+  EXPECT_EQ(dimacs.sink, 5);
+  EXPECT_EQ(dimacs.graph.maxFlow(dimacs.source, dimacs.sink), 23);
+}
+
+TEST(PushRelabel, disconnected)
+{
+  Graph g(5);
+  g.connect(0,1,4);
+  g.connect(1,2,3);
+  g.connect(3,4,5);
+
+  EXPECT_THAT(g.maxFlow(0,4, Method::RelabelToFront), testing::Eq(0));
+  EXPECT_THAT(g.maxFlow(0,4, Method::HighestLabel), testing::Eq(0));
+}
+
+TEST(PushRelabel, layered)
+{
+  for(unsigned seed=1; seed<=5; ++seed) {
+    Graph g = layeredNetwork(6, 8, 3, 20, seed);
+    const int sink = 6*8+1;
+    EXPECT_THAT(g.maxFlow(0, sink, Method::HighestLabel), testing::Eq(g.maxFlow(0, sink, Method::RelabelToFront)));
+  }
+}
+
+TEST(PushRelabel, parallel)
+{
+  Graph g(6);
+  g.connect(0,1,16);
+  g.connect(0,2,13);
+  g.connect(1,3,12);
+  g.connect(2,1,4);
+  g.connect(2,4,14);
+  g.connect(3,2,9);
+  g.connect(3,5,20);
+  g.connect(4,3,7);
+  g.connect(4,5,4);
+  EXPECT_THAT(g.maxFlow(0,5, Method::Parallel, 1), testing::Eq(23));
+  EXPECT_THAT(g.maxFlow(0,5, Method::Parallel, 3), testing::Eq(23));
+
+  for(unsigned seed=1; seed<=5; ++seed) {
+    Graph g = layeredNetwork(10, 20, 3, 50, seed);
+    const int sink = 10*20+1;
+    const int expected = g.maxFlow(0, sink, Method::HighestLabel);
+    for(unsigned threads: {0, 1, 2, 4}) {
+      EXPECT_THAT(g.maxFlow(0, sink, Method::Parallel, threads), testing::Eq(expected));
+    }
+  }
+}
+
+TEST(PushRelabel, DISABLED_benchmark)
+{
+  Graph g = layeredNetwork(50, 100, 4, 1000, 42);
+  const int sink = 50*100+1;
+
+  auto run = [&](const char* name, Method m) {
+    auto start = std::chrono::steady_clock::now();
+    const int f = g.maxFlow(0, sink, m);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << name << ": flow " << f << " in " << elapsed.count() << " ms" << std::endl;
+  };
+  run("highest label", Method::HighestLabel);
+  run("relabel to front", Method::RelabelToFront);
+}
+
+TEST(PushRelabel, DISABLED_parallelScaling)
+{
+  Graph g = layeredNetwork(200, 1000, 4, 1000, 42);
+  const int sink = 200*1000+1;
+
+  auto start = std::chrono::steady_clock::now();
+  const int expected = g.maxFlow(0, sink, Method::HighestLabel);
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  std::cout << "sequential: flow " << expected << " in " << elapsed.count() << " ms" << std::endl;
+
+  for(unsigned threads=1; threads<=hardwareThreads(); threads*=2) {
+    start = std::chrono::steady_clock::now();
+    EXPECT_THAT(g.maxFlow(0, sink, Method::Parallel, threads), testing::Eq(expected));
+    elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << threads << " threads: " << elapsed.count() << " ms" << std::endl;
+  }
 }
 
 } // push_relabel
-} // namespace algo
\ No newline at end of file
+} // namespace algo
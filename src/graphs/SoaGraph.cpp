@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <GraphGenerator.hpp>
+#include <SoaGraph.hpp>
+
+namespace algo {
+namespace {
+
+using Graph = GenericGraph<WeightedEdge>;
+
+} // namespace
+
+TEST(SoaGraph, columns)
+{
+  Graph g = generate::erdosRenyi(200, 1000, 1, 50).graph<Graph>();
+  for(unsigned threads: {1u, 3u}) {
+    SoaGraph<> soa(g, threads);
+    ASSERT_EQ(soa.vertices(), 200);
+    ASSERT_EQ(soa.edgeCount(), 1000);
+    auto weight = soa.edgeColumn(g, [](const WeightedEdge& e) { return e.weight; }, threads);
+    for(int u=0; u<200; ++u) {
+      ASSERT_EQ(soa.edges(u).size(), g.edges(u).size());
+      size_t i = 0;
+      for(const auto e: soa.edges(u)) {
+        EXPECT_EQ(e.to, g.edges(u)[i].to);
+        EXPECT_EQ(soa.target(e.id), e.to);
+        EXPECT_EQ(weight[e.id], g.edges(u)[i].weight);
+        ++i;
+      }
+    }
+  }
+}
+
+TEST(SoaGraph, traversal)
+{
+  // Only edges lighter than the limit, the state reads the weight column by edge id
+  Graph g = generate::erdosRenyi(300, 1200, 2, 10).graph<Graph>();
+  SoaGraph<> soa(g);
+  const auto weight = soa.edgeColumn(g, [](const WeightedEdge& e) { return e.weight; });
+
+  struct Light: public Graph::TraversalState
+  {
+    Light(size_t n): Graph::TraversalState(n) {}
+    bool validEdge(const WeightedEdge& e) override { return e.weight < 5; }
+  };
+  Light expected(300);
+  g.bfsImpl(0, expected);
+
+  struct ColumnState
+  {
+    ColumnState(size_t n, const std::vector<int>& w): discovered(n, false), processed(n, false), parent(n, -1), weight(w) {}
+    void processEarly(int) {}
+    void processLate(int) {}
+    void processEdge(int, const EdgeRef&) {}
+    bool validEdge(const EdgeRef& e) { return weight[e.id] < 5; }
+
+    std::vector<bool> discovered;
+    std::vector<bool> processed;
+    std::vector<int> parent;
+    const std::vector<int>& weight;
+  };
+  ColumnState actual(300, weight);
+  breadthFirst(soa, 0, actual);
+  EXPECT_EQ(actual.discovered, expected.discovered);
+  EXPECT_EQ(actual.parent, expected.parent);
+
+  auto depth = soa.vertexColumn<int>(-1);
+  EXPECT_EQ(depth.size(), 300);
+}
+
+} // namespace algo
@@ -1,63 +1,79 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <CompressedGraph.hpp>
+#include <CsrGraph.hpp>
 #include <Graph.hpp>
 
 namespace algo {
 namespace scc {
 
-struct Graph: public GenericGraph<> 
-{
-  Graph(size_t s): GenericGraph(s) {}
+template<typename G>
+using State = typename GenericGraph<typename G::EdgeType>::TraversalState;
 
-  VerticeList topologicalSort()
+template<typename G>
+std::vector<int> topologicalSort(const G& g)
+{
+  struct Sorted: public State<G>
   {
-    struct State: public TraversalState
+    Sorted(size_t s): State<G>(s)
+    {
+      sorted.reserve(s);
+    }
+    void processLate(int u) override
     {
-      State(size_t s): TraversalState(s)
-      {
-        sorted.reserve(s);
-      }
-      void processLate(int u) override
-      {
-        sorted.push_back(u);
-      }
-      VerticeList sorted;
-    };
-
-    State state(size);
-    for(int u=0; u<size; ++u) {
-      if(!state.processed[u]) {
-        dfsImpl(u, state);
-      }
+      sorted.push_back(u);
+    }
+    std::vector<int> sorted;
+  };
+
+  Sorted state(g.vertices());
+  for(size_t u=0; u<g.vertices(); ++u) {
+    if(!state.processed[u]) {
+      depthFirst(g, u, state);
     }
-    std::reverse(state.sorted.begin(), state.sorted.end());
-    return state.sorted;
   }
+  std::reverse(state.sorted.begin(), state.sorted.end());
+  return state.sorted;
+}
 
-  auto scc()
+// Kosaraju: DFS on the transposed graph in topological order of g, every tree is a
+// component. Works on any graph type, gt has to hold the reversed edges of g.
+template<typename G, typename GT>
+std::vector<std::vector<int>> stronglyConnectedComponents(const G& g, const GT& gt)
+{
+  struct Components: public State<GT>
   {
-    Graph gt(*this);
-    gt.transpose();
-
-    struct State: public TraversalState
+    Components(size_t s): State<GT>(s) {}
+    void processLate(int u) override
     {
-      State(size_t s): TraversalState(s) {}
-      void processLate(int u) override
-      {
-        components.back().push_back(u);
-      }
-      std::vector<VerticeList> components;
-    };
-
-    State state(size);
-    for(int s: topologicalSort()) {
-      if(!state.processed[s]) {
-        state.components.emplace_back();
-        gt.dfsImpl(s, state);
-      }
+      components.back().push_back(u);
+    }
+    std::vector<std::vector<int>> components;
+  };
+
+  Components state(g.vertices());
+  for(int s: topologicalSort(g)) {
+    if(!state.processed[s]) {
+      state.components.emplace_back();
+      depthFirst(gt, s, state);
     }
-    return state.components;
+  }
+  return state.components;
+}
+
+struct Graph: public GenericGraph<> 
+{
+  Graph(size_t s): GenericGraph(s) {}
+
+  VerticeList topologicalSort()
+  {
+    return scc::topologicalSort(*this);
+  }
+
+  auto scc() const
+  {
+    return stronglyConnectedComponents(*this, transposeCsr(*this));
   }
 };
 
@@ -88,5 +104,33 @@ TEST(StronglyConnectedComponents, test1)
   EXPECT_THAT(components[3], testing::UnorderedElementsAre(7));
 }
 
+TEST(StronglyConnectedComponents, compressed)
+{
+  Graph g(8);
+  g.connect(0,1);
+  g.connect(1,2);
+  g.connect(1,4);
+  g.connect(1,5);
+  g.connect(2,3);
+  g.connect(2,6);
+  g.connect(3,2);
+  g.connect(3,7);
+  g.connect(4,0);
+  g.connect(4,5);
+  g.connect(5,6);
+  g.connect(6,5);
+  g.connect(6,7);
+  g.connect(7,7);
+
+  CompressedGraph cg(g);
+  auto components = stronglyConnectedComponents(cg, cg.transposed());
+
+  ASSERT_THAT(components.size(), testing::Eq(4));
+  EXPECT_THAT(components[0], testing::UnorderedElementsAre(0,1,4));
+  EXPECT_THAT(components[1], testing::UnorderedElementsAre(2,3));
+  EXPECT_THAT(components[2], testing::UnorderedElementsAre(5,6));
+  EXPECT_THAT(components[3], testing::UnorderedElementsAre(7));
+}
+
 } // namespace scc
 } // namespace algo
\ No newline at end of file
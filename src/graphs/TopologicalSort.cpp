@@ -1,40 +1,49 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <CompressedGraph.hpp>
 #include <Graph.hpp>
+#include <GraphGenerator.hpp>
 
 namespace algo {
 namespace topo {
 
+// DFS finishing order reversed, any graph with vertices(), edges(u) and Directed
+template<typename G>
+std::vector<int> topologicalSort(const G& g)
+{
+  struct State: public GenericGraph<typename G::EdgeType>::TraversalState
+  {
+    State(size_t s): GenericGraph<typename G::EdgeType>::TraversalState(s)
+    {
+      sorted.reserve(s);
+    }
+
+    void processLate(int u) override
+    {
+      sorted.push_back(u);
+    }
+
+    std::vector<int> sorted;
+  };
+
+  State state(g.vertices());
+  for(size_t u=0; u<g.vertices(); ++u) {
+    if(!state.processed[u]) {
+      depthFirst(g, u, state);
+    }
+  }
+  std::reverse(state.sorted.begin(), state.sorted.end());
+  return state.sorted;
+}
+
 struct Graph: public GenericGraph<>
 {
   Graph(size_t s): GenericGraph(s) {}
 
   VerticeList topologicalSort()
   {
-    struct State: public TraversalState
-    {
-      State(size_t s): TraversalState(s)
-      {
-        sorted.reserve(s);
-      }
-
-      void processLate(int u) override
-      {
-        sorted.push_back(u);
-      }
-
-      VerticeList sorted;
-    };
-
-    State state(size);
-    for(int u=0; u<size; ++u) {
-      if(!state.processed[u]) {
-        dfsImpl(u, state);
-      }
-    }
-    std::reverse(state.sorted.begin(), state.sorted.end());
-    return state.sorted;
+    return topo::topologicalSort(*this);
   }
 };
 
@@ -53,5 +62,21 @@ TEST(TolopologicalSort, test1)
   ASSERT_THAT(sorted, testing::ElementsAre(0,3,4,2,1));
 }
 
+TEST(TolopologicalSort, compressed)
+{
+  CompressedGraph g(generate::randomDag(1000, 5000, 7).csr());
+  auto sorted = topologicalSort(g);
+  ASSERT_THAT(sorted.size(), testing::Eq(1000));
+  std::vector<int> position(1000);
+  for(int i=0; i<1000; ++i) {
+    position[sorted[i]] = i;
+  }
+  for(int u=0; u<1000; ++u) {
+    for(const auto& e: g.edges(u)) {
+      EXPECT_LT(position[u], position[e.to]);
+    }
+  }
+}
+
 } // namespace topo
 } // namespace algo
\ No newline at end of file
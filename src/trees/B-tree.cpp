@@ -2,10 +2,16 @@
 #include <gmock/gmock.h>
 
 #include <algorithm>
+#include <chrono>
+#include <limits>
 #include <memory>
+#include <random>
+#include <set>
 #include <vector>
 #include <queue>
 
+#include <NodeArena.hpp>
+
 namespace algo {
 namespace btree {
 
@@ -127,6 +133,7 @@ public:
     }
     if(_leaf) {
       _keys.insert(kit, k);
+      return true;
     } else {
       const size_t i = std::distance(_keys.begin(), kit);
       // DISK_READ(child, i);
@@ -261,6 +268,262 @@ private:
   typename node_t::ptr_t _root;
 };
 
+// Node of ArenaTree: fixed size, keys and 32 bit child ids inline, cache line aligned.
+// With int keys and T = 8 the 16 bit count and the leaf flag share the first key slot,
+// so a node is two cache lines.
+template<typename Key, size_t T>
+struct alignas(64) FlatNode
+{
+  static constexpr size_t MAX_KEYS = 2*T - 1;
+  static_assert(MAX_KEYS <= std::numeric_limits<uint16_t>::max(), "Key count must fit in 16 bits");
+
+  uint16_t count = 0;
+  bool leaf = true;
+  Key keys[MAX_KEYS];
+  uint32_t children[2*T];
+
+  size_t find(const Key& k) const
+  {
+    return std::lower_bound(keys, keys + count, k) - keys;
+  }
+
+  bool full() const
+  {
+    return count == MAX_KEYS;
+  }
+};
+
+// Same algorithms as Tree (CLRS, minimum degree T, single pass top-down insert and
+// remove) on nodes from a NodeArena: no per node allocation, no refcounting, children
+// one id lookup away.
+template<typename Key, size_t T = 8>
+class ArenaTree
+{
+public:
+  using node_t = FlatNode<Key, T>;
+  using Id = typename NodeArena<node_t>::Id;
+
+  ArenaTree(): _root(_nodes.allocate()) {}
+
+  bool search(const Key& k) const
+  {
+    Id id = _root;
+    while(true) {
+      const node_t& x = _nodes[id];
+      const size_t i = x.find(k);
+      if(i < x.count && x.keys[i] == k) {
+        return true;
+      } else if(x.leaf) {
+        return false;
+      }
+      id = x.children[i];
+    }
+  }
+
+  bool insert(const Key& k)
+  {
+    if(_nodes[_root].full()) {
+      const Id s = _nodes.allocate();
+      _nodes[s].leaf = false;
+      _nodes[s].children[0] = _root;
+      _root = s;
+      splitChild(s, 0);
+    }
+    Id id = _root;
+    while(true) {
+      node_t& x = _nodes[id];
+      size_t i = x.find(k);
+      if(i < x.count && x.keys[i] == k) {
+        return false;
+      }
+      if(x.leaf) {
+        std::move_backward(x.keys + i, x.keys + x.count, x.keys + x.count + 1);
+        x.keys[i] = k;
+        ++x.count;
+        ++_size;
+        return true;
+      }
+      if(_nodes[x.children[i]].full()) {
+        splitChild(id, i);
+        if(x.keys[i] == k) {
+          return false;
+        } else if(x.keys[i] < k) {
+          ++i;
+        }
+      }
+      id = x.children[i];
+    }
+  }
+
+  bool remove(const Key& k)
+  {
+    if(!search(k)) {
+      return false;
+    }
+    remove(_root, k);
+    --_size;
+    node_t& root = _nodes[_root];
+    if(root.count == 0 && !root.leaf) {
+      const Id old = _root;
+      _root = root.children[0];
+      _nodes.release(old);
+    }
+    return true;
+  }
+
+  size_t size() const
+  {
+    return _size;
+  }
+
+  size_t memory() const
+  {
+    return _nodes.memory();
+  }
+
+  // Checks order, node occupancy and equal leaf depth
+  bool valid() const
+  {
+    int leafDepth = -1;
+    return valid(_root, nullptr, nullptr, 0, leafDepth);
+  }
+
+private:
+  void splitChild(Id parent, size_t i)
+  {
+    const Id z = _nodes.allocate();
+    node_t& x = _nodes[parent];
+    node_t& y = _nodes[x.children[i]];
+    node_t& n = _nodes[z];
+    n.leaf = y.leaf;
+    n.count = T - 1;
+    std::copy(y.keys + T, y.keys + 2*T - 1, n.keys);
+    if(!y.leaf) {
+      std::copy(y.children + T, y.children + 2*T, n.children);
+    }
+    y.count = T - 1;
+
+    std::move_backward(x.keys + i, x.keys + x.count, x.keys + x.count + 1);
+    std::move_backward(x.children + i + 1, x.children + x.count + 1, x.children + x.count + 2);
+    x.keys[i] = y.keys[T-1];
+    x.children[i+1] = z;
+    ++x.count;
+  }
+
+  // Appends separator i and child i+1 of x to child i, child i+1 is released
+  void merge(node_t& x, size_t i)
+  {
+    node_t& y = _nodes[x.children[i]];
+    node_t& z = _nodes[x.children[i+1]];
+    y.keys[y.count] = x.keys[i];
+    std::copy(z.keys, z.keys + z.count, y.keys + y.count + 1);
+    if(!y.leaf) {
+      std::copy(z.children, z.children + z.count + 1, y.children + y.count + 1);
+    }
+    y.count += z.count + 1;
+    _nodes.release(x.children[i+1]);
+    std::move(x.keys + i + 1, x.keys + x.count, x.keys + i);
+    std::move(x.children + i + 2, x.children + x.count + 1, x.children + i + 1);
+    --x.count;
+  }
+
+  // k is in the subtree of id, every node entered has at least T keys (except the root)
+  void remove(Id id, const Key& k)
+  {
+    node_t& x = _nodes[id];
+    size_t i = x.find(k);
+    if(i < x.count && x.keys[i] == k) {
+      if(x.leaf) {
+        std::move(x.keys + i + 1, x.keys + x.count, x.keys + i);
+        --x.count;
+        return;
+      }
+      const Id y = x.children[i];
+      const Id z = x.children[i+1];
+      if(_nodes[y].count >= T) {
+        Id p = y;
+        while(!_nodes[p].leaf) {
+          p = _nodes[p].children[_nodes[p].count];
+        }
+        x.keys[i] = _nodes[p].keys[_nodes[p].count - 1];
+        remove(y, x.keys[i]);
+      } else if(_nodes[z].count >= T) {
+        Id p = z;
+        while(!_nodes[p].leaf) {
+          p = _nodes[p].children[0];
+        }
+        x.keys[i] = _nodes[p].keys[0];
+        remove(z, x.keys[i]);
+      } else {
+        merge(x, i);
+        remove(y, k);
+      }
+      return;
+    }
+
+    node_t& c = _nodes[x.children[i]];
+    if(c.count < T) {
+      node_t* left = i > 0 ? &_nodes[x.children[i-1]] : nullptr;
+      node_t* right = i < x.count ? &_nodes[x.children[i+1]] : nullptr;
+      if(left && left->count >= T) {
+        std::move_backward(c.keys, c.keys + c.count, c.keys + c.count + 1);
+        c.keys[0] = x.keys[i-1];
+        if(!c.leaf) {
+          std::move_backward(c.children, c.children + c.count + 1, c.children + c.count + 2);
+          c.children[0] = left->children[left->count];
+        }
+        x.keys[i-1] = left->keys[left->count - 1];
+        --left->count;
+        ++c.count;
+      } else if(right && right->count >= T) {
+        c.keys[c.count] = x.keys[i];
+        if(!c.leaf) {
+          c.children[c.count + 1] = right->children[0];
+          std::move(right->children + 1, right->children + right->count + 1, right->children);
+        }
+        ++c.count;
+        x.keys[i] = right->keys[0];
+        std::move(right->keys + 1, right->keys + right->count, right->keys);
+        --right->count;
+      } else if(left) {
+        merge(x, --i);
+      } else {
+        merge(x, i);
+      }
+    }
+    remove(x.children[i], k);
+  }
+
+  bool valid(Id id, const Key* low, const Key* high, int depth, int& leafDepth) const
+  {
+    const node_t& x = _nodes[id];
+    if((id != _root && x.count < T - 1) || x.count > node_t::MAX_KEYS) {
+      return false;
+    }
+    for(size_t i=0; i<x.count; ++i) {
+      if((i > 0 && !(x.keys[i-1] < x.keys[i])) || (low && !(*low < x.keys[i])) || (high && !(x.keys[i] < *high))) {
+        return false;
+      }
+    }
+    if(x.leaf) {
+      if(leafDepth < 0) {
+        leafDepth = depth;
+      }
+      return leafDepth == depth;
+    }
+    for(size_t i=0; i<=x.count; ++i) {
+      if(!valid(x.children[i], i > 0 ? &x.keys[i-1] : low, i < x.count ? &x.keys[i] : high, depth + 1, leafDepth)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  NodeArena<node_t> _nodes;
+  Id _root;
+  size_t _size = 0;
+};
+
 TEST(BTree, test1)
 {
   Tree<char> t(3);
@@ -298,5 +561,61 @@ TEST(BTree, test1)
   // t.print();
 }
 
+TEST(BTree, arena)
+{
+  ArenaTree<int, 3> t;
+  std::set<int> model;
+  std::mt19937 gen(5);
+  std::uniform_int_distribution<int> key(0, 2000);
+  for(int i=0; i<20000; ++i) {
+    const int k = key(gen);
+    if(gen() % 3) {
+      EXPECT_EQ(t.insert(k), model.insert(k).second);
+    } else {
+      EXPECT_EQ(t.remove(k), model.erase(k) == 1);
+    }
+    if(i % 1000 == 0) {
+      ASSERT_TRUE(t.valid());
+    }
+  }
+  ASSERT_TRUE(t.valid());
+  EXPECT_EQ(t.size(), model.size());
+  for(int k=0; k<=2000; ++k) {
+    EXPECT_EQ(t.search(k), model.count(k) == 1);
+  }
+  for(int k: std::vector<int>(model.begin(), model.end())) {
+    EXPECT_TRUE(t.remove(k));
+  }
+  EXPECT_EQ(t.size(), 0);
+  EXPECT_TRUE(t.valid());
+  EXPECT_EQ(sizeof(FlatNode<int, 8>), 128);
+}
+
+TEST(BTree, DISABLED_benchmark)
+{
+  const int n = 200000;
+  std::vector<int> keys(n);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(1));
+
+  auto run = [&](const char* name, auto& tree) {
+    auto time = [](auto&& fn) {
+      auto start = std::chrono::steady_clock::now();
+      fn();
+      return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+    size_t found = 0;
+    const double insert = time([&] { for(int k: keys) tree.insert(k); });
+    const double search = time([&] { for(int k: keys) found += tree.search(k ^ 1); });
+    const double remove = time([&] { for(int k: keys) tree.remove(k); });
+    EXPECT_EQ(found, n);
+    std::cout << name << ": insert " << insert << "ms, search " << search << "ms, remove " << remove << "ms" << std::endl;
+  };
+  Tree<int> shared(8);
+  ArenaTree<int, 8> arena;
+  run("Tree<int>", shared);
+  run("ArenaTree<int>", arena);
+}
+
 } // namespace btree
 } // namespace algo
\ No newline at end of file
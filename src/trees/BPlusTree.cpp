@@ -0,0 +1,740 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <NodeArena.hpp>
+#include <Parallel.hpp>
+
+namespace algo {
+namespace bplus {
+
+// Leaf holds up to N entries, keys and values in separate inline arrays, and the ids of
+// its neighbours so that a range is walked leaf after leaf
+template<typename Key, typename Value, size_t N>
+struct alignas(64) Leaf
+{
+  uint32_t count = 0;
+  uint32_t prev = ~0u;
+  uint32_t next = ~0u;
+  Key keys[N];
+  Value values[N];
+};
+
+// Inner node with up to N separators, keys of child i are < keys[i] <= keys of child i+1
+template<typename Key, size_t N>
+struct alignas(64) Inner
+{
+  uint32_t count = 0;
+  Key keys[N];
+  uint32_t children[N+1];
+};
+
+// B+ tree map, values live only in the leaves which form a doubly linked list in key
+// order. Nodes come from arenas like btree::ArenaTree's, every node but the root keeps
+// at least N/2 entries. Removal borrows from or merges with a sibling, separators left
+// behind by removed keys stay valid bounds.
+template<typename Key, typename Value, size_t N = 32>
+class Tree
+{
+  static_assert(N >= 4, "Nodes need room for at least 4 entries");
+
+public:
+  using leaf_t = Leaf<Key, Value, N>;
+  using inner_t = Inner<Key, N>;
+  using Id = uint32_t;
+  static constexpr Id NONE = ~Id(0);
+
+  class Iterator
+  {
+  public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::pair<Key, Value>;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::pair<const Key&, const Value&>;
+    using pointer = void;
+
+    Iterator(const Tree* tree, Id leaf, uint32_t i): _tree(tree), _leaf(leaf), _i(i) {}
+
+    const Key& key() const
+    {
+      return _tree->_leaves[_leaf].keys[_i];
+    }
+
+    const Value& value() const
+    {
+      return _tree->_leaves[_leaf].values[_i];
+    }
+
+    reference operator*() const
+    {
+      return {key(), value()};
+    }
+
+    Iterator& operator++()
+    {
+      if(++_i == _tree->_leaves[_leaf].count) {
+        _leaf = _tree->_leaves[_leaf].next;
+        _i = 0;
+      }
+      return *this;
+    }
+
+    // Decrementing end() gives the last entry
+    Iterator& operator--()
+    {
+      if(_leaf == NONE) {
+        _leaf = _tree->_last;
+        _i = _tree->_leaves[_leaf].count - 1;
+      } else if(_i == 0) {
+        _leaf = _tree->_leaves[_leaf].prev;
+        _i = _tree->_leaves[_leaf].count - 1;
+      } else {
+        --_i;
+      }
+      return *this;
+    }
+
+    bool operator==(const Iterator& rhs) const
+    {
+      return _leaf == rhs._leaf && _i == rhs._i;
+    }
+
+    bool operator!=(const Iterator& rhs) const
+    {
+      return !(*this == rhs);
+    }
+
+  private:
+    friend class Tree;
+
+    const Tree* _tree;
+    Id _leaf;
+    uint32_t _i;
+  };
+
+  Tree(): _root(_leaves.allocate()), _first(_root), _last(_root) {}
+
+  size_t size() const
+  {
+    return _size;
+  }
+
+  Iterator begin() const
+  {
+    return _leaves[_first].count ? Iterator(this, _first, 0) : end();
+  }
+
+  Iterator end() const
+  {
+    return Iterator(this, NONE, 0);
+  }
+
+  // First entry with key >= k
+  Iterator lowerBound(const Key& k) const
+  {
+    const Id id = descend(k, nullptr);
+    const leaf_t& leaf = _leaves[id];
+    const uint32_t i = std::lower_bound(leaf.keys, leaf.keys + leaf.count, k) - leaf.keys;
+    if(i < leaf.count) {
+      return Iterator(this, id, i);
+    }
+    return leaf.next == NONE ? end() : Iterator(this, leaf.next, 0);
+  }
+
+  Iterator find(const Key& k) const
+  {
+    Iterator it = lowerBound(k);
+    return it != end() && !(k < it.key()) ? it : end();
+  }
+
+  bool search(const Key& k) const
+  {
+    return find(k) != end();
+  }
+
+  // Calls fn(key, value) for the keys in [lo, hi) in order, returns how many
+  template<typename F>
+  size_t scan(const Key& lo, const Key& hi, F&& fn) const
+  {
+    const Iterator first = lowerBound(lo);
+    size_t visited = 0;
+    uint32_t i = first._i;
+    for(Id id=first._leaf; id != NONE; id=_leaves[id].next, i=0) {
+      const leaf_t& leaf = _leaves[id];
+      for(; i<leaf.count; ++i) {
+        if(!(leaf.keys[i] < hi)) {
+          return visited;
+        }
+        fn(leaf.keys[i], leaf.values[i]);
+        ++visited;
+      }
+    }
+    return visited;
+  }
+
+  // False if k is already present, its value is left untouched
+  bool insert(const Key& k, const Value& v)
+  {
+    std::vector<Step> path;
+    const Id id = descend(k, &path);
+    leaf_t& leaf = _leaves[id];
+    uint32_t i = std::lower_bound(leaf.keys, leaf.keys + leaf.count, k) - leaf.keys;
+    if(i < leaf.count && !(k < leaf.keys[i])) {
+      return false;
+    }
+    ++_size;
+    if(leaf.count < N) {
+      insertAt(leaf, i, k, v);
+      return true;
+    }
+
+    const Id rightId = _leaves.allocate();
+    leaf_t& right = _leaves[rightId];
+    const uint32_t keep = N - N/2;
+    right.count = N/2;
+    std::move(leaf.keys + keep, leaf.keys + N, right.keys);
+    std::move(leaf.values + keep, leaf.values + N, right.values);
+    leaf.count = keep;
+    right.prev = id;
+    right.next = leaf.next;
+    if(leaf.next != NONE) {
+      _leaves[leaf.next].prev = rightId;
+    } else {
+      _last = rightId;
+    }
+    leaf.next = rightId;
+    if(i <= keep) {
+      insertAt(leaf, i, k, v);
+    } else {
+      insertAt(right, i - keep, k, v);
+    }
+    insertSeparator(path, right.keys[0], rightId);
+    return true;
+  }
+
+  bool remove(const Key& k)
+  {
+    std::vector<Step> path;
+    const Id id = descend(k, &path);
+    leaf_t& leaf = _leaves[id];
+    const uint32_t i = std::lower_bound(leaf.keys, leaf.keys + leaf.count, k) - leaf.keys;
+    if(i == leaf.count || k < leaf.keys[i]) {
+      return false;
+    }
+    std::move(leaf.keys + i + 1, leaf.keys + leaf.count, leaf.keys + i);
+    std::move(leaf.values + i + 1, leaf.values + leaf.count, leaf.values + i);
+    --leaf.count;
+    --_size;
+    if(path.empty() || leaf.count >= N/2) {
+      return true;
+    }
+
+    inner_t& x = _inners[path.back().node];
+    const uint32_t c = path.back().child;
+    leaf_t* left = c > 0 ? &_leaves[x.children[c-1]] : nullptr;
+    leaf_t* right = c < x.count ? &_leaves[x.children[c+1]] : nullptr;
+    if(left && left->count > N/2) {
+      insertAt(leaf, 0, left->keys[left->count - 1], left->values[left->count - 1]);
+      --left->count;
+      x.keys[c-1] = leaf.keys[0];
+      return true;
+    } else if(right && right->count > N/2) {
+      insertAt(leaf, leaf.count, right->keys[0], right->values[0]);
+      std::move(right->keys + 1, right->keys + right->count, right->keys);
+      std::move(right->values + 1, right->values + right->count, right->values);
+      --right->count;
+      x.keys[c] = right->keys[0];
+      return true;
+    }
+    mergeLeaves(x, left ? c-1 : c);
+    shrink(path);
+    return true;
+  }
+
+  // Replaces the content by the (key, value) pairs of [first, last), which must be sorted
+  // by strictly increasing key. Bottom up in O(n): leaves are packed to fill*N entries and
+  // inner nodes to fill*(N+1) children, both at least half full, and the leaf runs are
+  // written by threads in parallel into preallocated nodes.
+  template<typename It>
+  void bulkLoad(It first, It last, double fill = 1.0, unsigned threads = hardwareThreads())
+  {
+    if(!(fill > 0 && fill <= 1)) {
+      throw std::invalid_argument("Fill factor must be in (0, 1]");
+    }
+    const size_t n = std::distance(first, last);
+    if(std::adjacent_find(first, last, [](const auto& a, const auto& b) { return !(a.first < b.first); }) != last) {
+      throw std::invalid_argument("Keys must be sorted and unique");
+    }
+    _leaves = NodeArena<leaf_t>();
+    _inners = NodeArena<inner_t>();
+    _height = 0;
+    _size = n;
+
+    // Entries of node i are [n*i/count, n*(i+1)/count)
+    const size_t leaves = nodeCount(n, fill*N, N/2);
+    _leaves.reserve(leaves);
+    std::vector<Id> level(leaves);
+    for(Id& id: level) {
+      id = _leaves.allocate();
+    }
+    std::vector<Key> low(leaves);
+    parallelFor(threads, leaves, [&](size_t begin, size_t end, unsigned) {
+      for(size_t l=begin; l<end; ++l) {
+        leaf_t& leaf = _leaves[level[l]];
+        const size_t from = n*l/leaves;
+        leaf.count = n*(l+1)/leaves - from;
+        for(uint32_t i=0; i<leaf.count; ++i) {
+          const auto& entry = first[from + i];
+          leaf.keys[i] = entry.first;
+          leaf.values[i] = entry.second;
+        }
+        leaf.prev = l > 0 ? level[l-1] : NONE;
+        leaf.next = l + 1 < leaves ? level[l+1] : NONE;
+        if(leaf.count) {
+          low[l] = leaf.keys[0];
+        }
+      }
+    });
+    _first = level.front();
+    _last = level.back();
+
+    while(level.size() > 1) {
+      const size_t children = level.size();
+      const size_t count = nodeCount(children, fill*(N+1), N/2 + 1);
+      std::vector<Id> parents(count);
+      std::vector<Key> parentLow(count);
+      for(size_t p=0; p<count; ++p) {
+        parents[p] = _inners.allocate();
+        inner_t& x = _inners[parents[p]];
+        const size_t from = children*p/count;
+        const size_t to = children*(p+1)/count;
+        x.count = to - from - 1;
+        std::copy(level.begin() + from, level.begin() + to, x.children);
+        std::copy(low.begin() + from + 1, low.begin() + to, x.keys);
+        parentLow[p] = low[from];
+      }
+      level = std::move(parents);
+      low = std::move(parentLow);
+      ++_height;
+    }
+    _root = level.front();
+  }
+
+  // Nodes in use, leaves and inner
+  size_t nodes() const
+  {
+    return _leaves.size() + _inners.size();
+  }
+
+  // Checks order, bounds, occupancy and the leaf chain
+  bool valid() const
+  {
+    size_t entries = 0;
+    Id previous = NONE;
+    for(Id id=_first; id != NONE; previous=id, id=_leaves[id].next) {
+      const leaf_t& leaf = _leaves[id];
+      if(leaf.prev != previous || (id != _root && leaf.count < N/2)) {
+        return false;
+      }
+      entries += leaf.count;
+    }
+    if(previous != _last || entries != _size) {
+      return false;
+    }
+    Id next = _first;
+    return valid(_root, _height, nullptr, nullptr, next) && next == NONE;
+  }
+
+private:
+  struct Step
+  {
+    Id node;
+    uint32_t child;
+  };
+
+  Id descend(const Key& k, std::vector<Step>* path) const
+  {
+    Id id = _root;
+    for(int level=0; level<_height; ++level) {
+      const inner_t& x = _inners[id];
+      const uint32_t c = std::upper_bound(x.keys, x.keys + x.count, k) - x.keys;
+      if(path) {
+        path->push_back({id, c});
+      }
+      id = x.children[c];
+    }
+    return id;
+  }
+
+  // Node count for n entries at about per entries each, never so many that a node gets
+  // fewer than least entries, and at least one
+  static size_t nodeCount(size_t n, double per, size_t least)
+  {
+    const size_t packed = static_cast<size_t>(std::ceil(n / std::max(per, static_cast<double>(least))));
+    return std::max<size_t>(1, std::min(packed, n / least));
+  }
+
+  static void insertAt(leaf_t& leaf, uint32_t i, const Key& k, const Value& v)
+  {
+    std::move_backward(leaf.keys + i, leaf.keys + leaf.count, leaf.keys + leaf.count + 1);
+    std::move_backward(leaf.values + i, leaf.values + leaf.count, leaf.values + leaf.count + 1);
+    leaf.keys[i] = k;
+    leaf.values[i] = v;
+    ++leaf.count;
+  }
+
+  // Adds separator and its right child after a split, splitting inner nodes up the path
+  void insertSeparator(std::vector<Step>& path, Key separator, Id child)
+  {
+    while(!path.empty()) {
+      const auto [id, c] = path.back();
+      path.pop_back();
+      inner_t& x = _inners[id];
+      if(x.count < N) {
+        std::move_backward(x.keys + c, x.keys + x.count, x.keys + x.count + 1);
+        std::move_backward(x.children + c + 1, x.children + x.count + 1, x.children + x.count + 2);
+        x.keys[c] = separator;
+        x.children[c+1] = child;
+        ++x.count;
+        return;
+      }
+      Key keys[N+1];
+      Id children[N+2];
+      std::copy(x.keys, x.keys + c, keys);
+      keys[c] = separator;
+      std::copy(x.keys + c, x.keys + N, keys + c + 1);
+      std::copy(x.children, x.children + c + 1, children);
+      children[c+1] = child;
+      std::copy(x.children + c + 1, x.children + N + 1, children + c + 2);
+
+      const uint32_t mid = (N + 1)/2;
+      const Id rightId = _inners.allocate();
+      inner_t& right = _inners[rightId];
+      x.count = mid;
+      std::copy(keys, keys + mid, x.keys);
+      std::copy(children, children + mid + 1, x.children);
+      right.count = N - mid;
+      std::copy(keys + mid + 1, keys + N + 1, right.keys);
+      std::copy(children + mid + 1, children + N + 2, right.children);
+      separator = keys[mid];
+      child = rightId;
+    }
+    const Id root = _inners.allocate();
+    inner_t& r = _inners[root];
+    r.count = 1;
+    r.keys[0] = separator;
+    r.children[0] = _root;
+    r.children[1] = child;
+    _root = root;
+    ++_height;
+  }
+
+  // Moves leaf i+1 of x into leaf i and drops separator i
+  void mergeLeaves(inner_t& x, uint32_t i)
+  {
+    const Id leftId = x.children[i];
+    const Id rightId = x.children[i+1];
+    leaf_t& left = _leaves[leftId];
+    leaf_t& right = _leaves[rightId];
+    std::move(right.keys, right.keys + right.count, left.keys + left.count);
+    std::move(right.values, right.values + right.count, left.values + left.count);
+    left.count += right.count;
+    left.next = right.next;
+    if(right.next != NONE) {
+      _leaves[right.next].prev = leftId;
+    } else {
+      _last = leftId;
+    }
+    _leaves.release(rightId);
+    removeSeparator(x, i);
+  }
+
+  // Moves inner child i+1 of x into child i, separator i comes down between them
+  void mergeInners(inner_t& x, uint32_t i)
+  {
+    inner_t& left = _inners[x.children[i]];
+    const Id rightId = x.children[i+1];
+    inner_t& right = _inners[rightId];
+    left.keys[left.count] = x.keys[i];
+    std::move(right.keys, right.keys + right.count, left.keys + left.count + 1);
+    std::move(right.children, right.children + right.count + 1, left.children + left.count + 1);
+    left.count += right.count + 1;
+    _inners.release(rightId);
+    removeSeparator(x, i);
+  }
+
+  static void removeSeparator(inner_t& x, uint32_t i)
+  {
+    std::move(x.keys + i + 1, x.keys + x.count, x.keys + i);
+    std::move(x.children + i + 2, x.children + x.count + 1, x.children + i + 1);
+    --x.count;
+  }
+
+  // Inner node at the end of path lost a child, rebalances it and its ancestors
+  void shrink(std::vector<Step>& path)
+  {
+    while(true) {
+      const Id id = path.back().node;
+      path.pop_back();
+      inner_t& x = _inners[id];
+      if(path.empty()) {
+        if(x.count == 0) {
+          _root = x.children[0];
+          _inners.release(id);
+          --_height;
+        }
+        return;
+      }
+      if(x.count >= N/2) {
+        return;
+      }
+      inner_t& parent = _inners[path.back().node];
+      const uint32_t c = path.back().child;
+      inner_t* left = c > 0 ? &_inners[parent.children[c-1]] : nullptr;
+      inner_t* right = c < parent.count ? &_inners[parent.children[c+1]] : nullptr;
+      if(left && left->count > N/2) {
+        std::move_backward(x.keys, x.keys + x.count, x.keys + x.count + 1);
+        std::move_backward(x.children, x.children + x.count + 1, x.children + x.count + 2);
+        x.keys[0] = parent.keys[c-1];
+        x.children[0] = left->children[left->count];
+        ++x.count;
+        parent.keys[c-1] = left->keys[left->count - 1];
+        --left->count;
+        return;
+      } else if(right && right->count > N/2) {
+        x.keys[x.count] = parent.keys[c];
+        x.children[x.count + 1] = right->children[0];
+        ++x.count;
+        parent.keys[c] = right->keys[0];
+        std::move(right->keys + 1, right->keys + right->count, right->keys);
+        std::move(right->children + 1, right->children + right->count + 1, right->children);
+        --right->count;
+        return;
+      }
+      mergeInners(parent, left ? c-1 : c);
+    }
+  }
+
+  // Subtree keys within [low, high), leaves met in chain order
+  bool valid(Id id, int height, const Key* low, const Key* high, Id& nextLeaf) const
+  {
+    if(height == 0) {
+      const leaf_t& leaf = _leaves[id];
+      if(id != nextLeaf) {
+        return false;
+      }
+      nextLeaf = leaf.next;
+      for(uint32_t i=0; i<leaf.count; ++i) {
+        if((i > 0 && !(leaf.keys[i-1] < leaf.keys[i])) || (low && leaf.keys[i] < *low) || (high && !(leaf.keys[i] < *high))) {
+          return false;
+        }
+      }
+      return true;
+    }
+    const inner_t& x = _inners[id];
+    if(x.count > N || (id != _root && x.count < N/2) || (id == _root && x.count == 0)) {
+      return false;
+    }
+    for(uint32_t i=0; i<=x.count; ++i) {
+      if(!valid(x.children[i], height - 1, i > 0 ? &x.keys[i-1] : low, i < x.count ? &x.keys[i] : high, nextLeaf)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  NodeArena<leaf_t> _leaves;
+  NodeArena<inner_t> _inners;
+  Id _root;
+  Id _first;
+  Id _last;
+  int _height = 0;  // Inner levels above the leaves
+  size_t _size = 0;
+};
+
+TEST(BPlusTree, operations)
+{
+  Tree<int, int, 4> t;
+  std::map<int, int> model;
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<int> key(0, 3000);
+  for(int i=0; i<30000; ++i) {
+    const int k = key(gen);
+    if(gen() % 3) {
+      EXPECT_EQ(t.insert(k, -k), model.emplace(k, -k).second);
+    } else {
+      EXPECT_EQ(t.remove(k), model.erase(k) == 1);
+    }
+    if(i % 1000 == 0) {
+      ASSERT_TRUE(t.valid());
+    }
+  }
+  ASSERT_TRUE(t.valid());
+  ASSERT_EQ(t.size(), model.size());
+  for(int k=0; k<=3000; k+=7) {
+    EXPECT_EQ(t.search(k), model.count(k) == 1);
+  }
+
+  std::vector<std::pair<int, int>> forward, backward;
+  for(auto it=t.begin(); it!=t.end(); ++it) {
+    forward.emplace_back(it.key(), it.value());
+  }
+  for(auto it=t.end(); it!=t.begin(); ) {
+    --it;
+    backward.emplace_back((*it).first, (*it).second);
+  }
+  std::reverse(backward.begin(), backward.end());
+  const std::vector<std::pair<int, int>> expected(model.begin(), model.end());
+  EXPECT_EQ(forward, expected);
+  EXPECT_EQ(backward, expected);
+
+  for(int k: std::vector<int>{-5, 0, 1, 1500, 2999, 3000, 4000}) {
+    auto it = t.lowerBound(k);
+    auto m = model.lower_bound(k);
+    if(m == model.end()) {
+      EXPECT_TRUE(it == t.end());
+    } else {
+      ASSERT_TRUE(it != t.end());
+      EXPECT_EQ(it.key(), m->first);
+    }
+  }
+
+  for(const auto& [k, v]: expected) {
+    EXPECT_TRUE(t.remove(k));
+  }
+  EXPECT_TRUE(t.valid());
+  EXPECT_EQ(t.size(), 0);
+  EXPECT_TRUE(t.begin() == t.end());
+}
+
+TEST(BPlusTree, scan)
+{
+  Tree<int, double> t;
+  for(int k=0; k<10000; k+=2) {
+    t.insert(k, k/2.0);
+  }
+  std::vector<int> keys;
+  double sum = 0;
+  EXPECT_EQ(t.scan(101, 121, [&](int k, double v) { keys.push_back(k); sum += v; }), 10);
+  EXPECT_THAT(keys, testing::ElementsAre(102, 104, 106, 108, 110, 112, 114, 116, 118, 120));
+  EXPECT_DOUBLE_EQ(sum, 555);
+  EXPECT_EQ(t.scan(0, 10000, [](int, double) {}), 5000);
+  EXPECT_EQ(t.scan(9999, 20000, [](int, double) {}), 0);
+  EXPECT_EQ(t.scan(50, 50, [](int, double) {}), 0);
+}
+
+TEST(BPlusTree, DISABLED_benchmark)
+{
+  const int n = 1000000;
+  std::vector<int> keys(n);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(1));
+  Tree<int, int> t;
+  std::map<int, int> m;
+  for(int k: keys) {
+    t.insert(k, k);
+    m.emplace(k, k);
+  }
+
+  auto time = [](auto&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  };
+  long long tsum = 0, msum = 0;
+  const double tree = time([&] {
+    for(int i=0; i<1000; ++i) {
+      t.scan(keys[i], keys[i] + 1000, [&](int, int v) { tsum += v; });
+    }
+  });
+  const double map = time([&] {
+    for(int i=0; i<1000; ++i) {
+      for(auto it=m.lower_bound(keys[i]); it!=m.end() && it->first < keys[i] + 1000; ++it) {
+        msum += it->second;
+      }
+    }
+  });
+  EXPECT_EQ(tsum, msum);
+  std::cout << "1000 scans of 1000 keys, B+ tree: " << tree << "ms, std::map: " << map << "ms" << std::endl;
+}
+
+TEST(BPlusTree, bulkLoad)
+{
+  for(size_t n: std::vector<size_t>{0, 1, 3, 4, 5, 17, 100, 5000}) {
+    for(double fill: {0.5, 0.7, 1.0}) {
+      std::vector<std::pair<int, int>> entries;
+      for(size_t i=0; i<n; ++i) {
+        entries.emplace_back(3*i, i);
+      }
+      Tree<int, int, 4> t;
+      t.insert(-1, -1);
+      t.bulkLoad(entries.begin(), entries.end(), fill, 3);
+      ASSERT_TRUE(t.valid());
+      ASSERT_EQ(t.size(), n);
+      const std::vector<std::pair<int, int>> loaded(t.begin(), t.end());
+      EXPECT_EQ(loaded, entries);
+      EXPECT_FALSE(t.search(-1));
+
+      for(int k=0; k<static_cast<int>(3*n); k+=2) {
+        EXPECT_EQ(t.insert(k, -k), k % 3 != 0);
+      }
+      for(int k=0; k<static_cast<int>(3*n); k+=5) {
+        t.remove(k);
+      }
+      ASSERT_TRUE(t.valid());
+    }
+  }
+
+  std::vector<std::pair<int, int>> entries;
+  for(int i=0; i<1000; ++i) {
+    entries.emplace_back(i, i);
+  }
+  Tree<int, int, 4> packed, loose;
+  packed.bulkLoad(entries.begin(), entries.end());
+  loose.bulkLoad(entries.begin(), entries.end(), 0.5);
+  EXPECT_EQ(packed.nodes(), 250 + 50 + 10 + 2 + 1);
+  EXPECT_GT(loose.nodes(), packed.nodes());
+
+  EXPECT_THROW(packed.bulkLoad(entries.begin(), entries.end(), 0), std::invalid_argument);
+  EXPECT_THROW(packed.bulkLoad(entries.rbegin(), entries.rend()), std::invalid_argument);
+  entries.push_back(entries.back());
+  EXPECT_THROW(packed.bulkLoad(entries.begin(), entries.end()), std::invalid_argument);
+}
+
+TEST(BPlusTree, DISABLED_bulkLoadBenchmark)
+{
+  const int n = 10000000;
+  std::vector<std::pair<int, int>> entries(n);
+  for(int i=0; i<n; ++i) {
+    entries[i] = {i, i};
+  }
+  auto time = [](auto&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  };
+  Tree<int, int> inserted, serial, parallel;
+  const double insert = time([&] {
+    for(const auto& [k, v]: entries) {
+      inserted.insert(k, v);
+    }
+  });
+  const double one = time([&] { serial.bulkLoad(entries.begin(), entries.end(), 1.0, 1); });
+  const double all = time([&] { parallel.bulkLoad(entries.begin(), entries.end()); });
+  EXPECT_TRUE(parallel.valid());
+  EXPECT_EQ(parallel.size(), n);
+  std::cout << "Insert: " << insert << "ms, " << inserted.nodes() << " nodes" << std::endl;
+  std::cout << "Bulk load, 1 thread: " << one << "ms, " << hardwareThreads() << " threads: " << all << "ms, " << parallel.nodes() << " nodes" << std::endl;
+}
+
+} // namespace bplus
+} // namespace algo